@@ -0,0 +1,296 @@
+#include "binary_tree.h"
+#include "benchmark_inputs.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <complex>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+// Регрессионный набор бенчмарков (Google Benchmark)
+// Каждая операция замеряется для всех инстанцированных типов ключей (int, float, double, string,
+// complex<double>), распределений входа (shuffled, sorted, zipfian) и размеров n.
+// Имя случая: Операция/тип/распределение/n, например Insert/string/zipfian/100000.
+// Входные данные строятся с фиксированными зёрнами, поэтому прогоны сравнимы между собой;
+// результаты всех проверок используются (DoNotOptimize), промахи и попадания сверяются с ожидаемыми.
+// Машиночитаемый вывод - стандартные флаги Google Benchmark:
+//   --benchmark_format=json|csv, --benchmark_out=<файл> --benchmark_out_format=json|csv
+// Дополнительный флаг: --tree_sizes=1000,100000 (по умолчанию), фильтр - --benchmark_filter=<regex>
+// Выделения памяти на ключ для длинных строк замеряются отдельно - lab4_string_allocs (benchmark_string_allocs.cpp)
+// Деревья строятся с BalancePolicy::AVL: на отсортированном входе без балансировки
+// вставка квадратична (этот случай - в performance_test_sorted, benchmark_reports.cpp)
+
+namespace {
+
+// Входные данные одного сочетания (тип, распределение, n), общие для всех операций
+template <typename T>
+struct Dataset {
+    std::vector<T> sequence; // Ключи в порядке вставки/обращений (для Ципфа - с повторами)
+    std::vector<T> unique;   // Ключи без повторов в порядке первого появления (удаление)
+    std::vector<T> misses;   // Отсутствующие ключи в том же порядке обращений
+    BinaryTree<T> tree;      // Дерево из sequence
+    BinaryTree<T> other;     // Дерево из отсутствующих ключей (второй операнд merge)
+    std::string text;        // serialize(PRE_ORDER)
+    std::string binary;      // serializeBinary()
+
+    Dataset(Distribution distribution, size_t n) : tree(BalancePolicy::AVL), other(BalancePolicy::AVL) {
+        std::vector<size_t> ranks = MakeRanks(distribution, n);
+        std::unordered_set<size_t> seen;
+        for (size_t rank : ranks) {
+            sequence.push_back(KeyTraits<T>::Make(2 * rank));
+            misses.push_back(KeyTraits<T>::Make(2 * rank + 1));
+            if (seen.insert(rank).second) {
+                unique.push_back(sequence.back());
+            }
+        }
+        for (const T& key : sequence) {
+            tree.Insert(key);
+        }
+        for (size_t rank = 0; rank < n; ++rank) {
+            other.Insert(KeyTraits<T>::Make(2 * rank + 1));
+        }
+        text = tree.serialize(TraversalType::PRE_ORDER);
+        binary = tree.serializeBinary();
+    }
+
+    // Данные строятся при первом обращении (вне замеряемого цикла) и переиспользуются
+    static const Dataset& Get(Distribution distribution, size_t n) {
+        static std::map<std::pair<Distribution, size_t>, std::unique_ptr<Dataset>> cache;
+        std::unique_ptr<Dataset>& slot = cache[{distribution, n}];
+        if (!slot) {
+            slot = std::make_unique<Dataset>(distribution, n);
+        }
+        return *slot;
+    }
+};
+
+// Операции
+
+template <typename T>
+void Insert(benchmark::State& state, Distribution distribution, size_t n) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tree = std::make_unique<BinaryTree<T>>(BalancePolicy::AVL);
+        state.ResumeTiming();
+        for (const T& key : data.sequence) {
+            tree->Insert(key);
+        }
+        benchmark::DoNotOptimize(tree->Size());
+        state.PauseTiming();
+        tree.reset(); // Освобождение узлов не входит в замер
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.sequence.size()));
+}
+
+// Contains: промах - TreeException (цена исключения входит в замер)
+template <typename T>
+void Contains(benchmark::State& state, Distribution distribution, size_t n, bool hit) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    const std::vector<T>& probes = hit ? data.sequence : data.misses;
+    size_t found = 0;
+    for (auto _ : state) {
+        found = 0;
+        for (const T& key : probes) {
+            try {
+                found += data.tree.Contains(key) ? 1 : 0;
+            }
+            catch (const TreeException&) {
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    if (found != (hit ? probes.size() : 0)) {
+        state.SkipWithError("Contains returned unexpected results");
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * probes.size()));
+}
+
+template <typename T>
+void TryContains(benchmark::State& state, Distribution distribution, size_t n, bool hit) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    const std::vector<T>& probes = hit ? data.sequence : data.misses;
+    size_t found = 0;
+    for (auto _ : state) {
+        found = 0;
+        for (const T& key : probes) {
+            found += data.tree.TryContains(key) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    if (found != (hit ? probes.size() : 0)) {
+        state.SkipWithError("TryContains returned unexpected results");
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * probes.size()));
+}
+
+// Удаление всех ключей в порядке распределения (копия дерева готовится вне замера)
+template <typename T>
+void Remove(benchmark::State& state, Distribution distribution, size_t n) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tree = std::make_unique<BinaryTree<T>>(data.tree);
+        state.ResumeTiming();
+        for (const T& key : data.unique) {
+            tree->Remove(key);
+        }
+        benchmark::DoNotOptimize(tree->Size());
+        state.PauseTiming();
+        tree.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.unique.size()));
+}
+
+template <typename T>
+void Traverse(benchmark::State& state, Distribution distribution, size_t n, TraversalType type) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        size_t visited = 0;
+        data.tree.Traverse(type, [&visited](T value) {
+            benchmark::DoNotOptimize(value);
+            ++visited;
+        });
+        benchmark::DoNotOptimize(visited);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.tree.Size()));
+}
+
+template <typename T>
+void Map(benchmark::State& state, Distribution distribution, size_t n) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        BinaryTree<T> result = data.tree.map([](T value) { return value; });
+        benchmark::DoNotOptimize(result.Size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.tree.Size()));
+}
+
+// Фильтр оставляет каждое второе значение
+template <typename T>
+void Where(benchmark::State& state, Distribution distribution, size_t n) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        size_t counter = 0;
+        BinaryTree<T> result = data.tree.where([&counter](T) { return (counter++ & 1) == 0; });
+        benchmark::DoNotOptimize(result.Size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.tree.Size()));
+}
+
+template <typename T>
+void Merge(benchmark::State& state, Distribution distribution, size_t n) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        BinaryTree<T> result = data.tree.merge(data.other);
+        benchmark::DoNotOptimize(result.Size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (data.tree.Size() + data.other.Size())));
+}
+
+template <typename T>
+void Copy(benchmark::State& state, Distribution distribution, size_t n) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        BinaryTree<T> copy(data.tree);
+        benchmark::DoNotOptimize(copy.Size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.tree.Size()));
+}
+
+template <typename T>
+void Serialize(benchmark::State& state, Distribution distribution, size_t n, bool binary) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        std::string result = binary ? data.tree.serializeBinary() : data.tree.serialize(TraversalType::PRE_ORDER);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.tree.Size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (binary ? data.binary : data.text).size()));
+}
+
+template <typename T>
+void Deserialize(benchmark::State& state, Distribution distribution, size_t n, bool binary) {
+    const Dataset<T>& data = Dataset<T>::Get(distribution, n);
+    for (auto _ : state) {
+        BinaryTree<T> tree;
+        if (binary) {
+            tree.deserializeBinary(data.binary);
+        } else {
+            tree.deserialize(data.text, TraversalType::PRE_ORDER);
+        }
+        benchmark::DoNotOptimize(tree.Size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.tree.Size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * (binary ? data.binary : data.text).size()));
+}
+
+// Регистрация
+
+const std::pair<TraversalType, const char*> TRAVERSALS[] = {
+    {TraversalType::PRE_ORDER, "pre_order"},
+    {TraversalType::REVERSE_PRE_ORDER, "reverse_pre_order"},
+    {TraversalType::IN_ORDER, "in_order"},
+    {TraversalType::REVERSE_IN_ORDER, "reverse_in_order"},
+    {TraversalType::POST_ORDER, "post_order"},
+    {TraversalType::REVERSE_POST_ORDER, "reverse_post_order"}
+};
+
+template <typename Function, typename... Args>
+void Register(const std::string& operation, const char* type, Distribution distribution, size_t n,
+              Function function, Args... args) {
+    std::string name = operation + "/" + type + "/" + DistributionName(distribution) + "/" + std::to_string(n);
+    benchmark::RegisterBenchmark(name.c_str(), function, distribution, n, args...);
+}
+
+template <typename T>
+void RegisterType(const std::vector<size_t>& sizes) {
+    const char* type = KeyTraits<T>::NAME;
+    for (Distribution distribution : {Distribution::SHUFFLED, Distribution::SORTED, Distribution::ZIPFIAN}) {
+        for (size_t n : sizes) {
+            Register("Insert", type, distribution, n, Insert<T>);
+            Register("Contains/hit", type, distribution, n, Contains<T>, true);
+            Register("Contains/miss", type, distribution, n, Contains<T>, false);
+            Register("TryContains/hit", type, distribution, n, TryContains<T>, true);
+            Register("TryContains/miss", type, distribution, n, TryContains<T>, false);
+            Register("Remove", type, distribution, n, Remove<T>);
+            for (const auto& [traversal, traversal_name] : TRAVERSALS) {
+                Register(std::string("Traverse/") + traversal_name, type, distribution, n, Traverse<T>, traversal);
+            }
+            Register("map", type, distribution, n, Map<T>);
+            Register("where", type, distribution, n, Where<T>);
+            Register("merge", type, distribution, n, Merge<T>);
+            Register("serialize/text", type, distribution, n, Serialize<T>, false);
+            Register("deserialize/text", type, distribution, n, Deserialize<T>, false);
+            Register("serialize/binary", type, distribution, n, Serialize<T>, true);
+            Register("deserialize/binary", type, distribution, n, Deserialize<T>, true);
+            Register("copy", type, distribution, n, Copy<T>);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes = TakeSizes(argc, argv);
+    RegisterType<int>(sizes);
+    RegisterType<float>(sizes);
+    RegisterType<double>(sizes);
+    RegisterType<std::string>(sizes);
+    RegisterType<std::complex<double>>(sizes);
+
+    benchmark::AddCustomContext("balance_policy", "AVL");
+    benchmark::AddCustomContext("input_seed", std::to_string(BENCHMARK_SEED));
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
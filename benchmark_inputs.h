@@ -0,0 +1,132 @@
+#ifndef BINARY_TREE_BENCHMARK_INPUTS_H
+#define BINARY_TREE_BENCHMARK_INPUTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Входные данные бенчмарков (lab4_benchmark, lab4_string_allocs): ключи по номерам,
+// распределения обращений с фиксированными зёрнами и разбор флага --tree_sizes
+
+// Фиксированное зерно всех входных данных
+constexpr unsigned BENCHMARK_SEED = 20240611;
+// Показатель распределения Ципфа (как в YCSB)
+constexpr double ZIPF_EXPONENT = 0.99;
+
+enum class Distribution {
+    SHUFFLED, // Все ключи по одному разу в случайном порядке
+    SORTED,   // Все ключи по одному разу по возрастанию
+    ZIPFIAN   // n обращений по закону Ципфа: горячие ключи повторяются (и разбросаны по диапазону)
+};
+
+inline const char* DistributionName(Distribution distribution) {
+    switch (distribution) {
+    case Distribution::SHUFFLED: return "shuffled";
+    case Distribution::SORTED: return "sorted";
+    case Distribution::ZIPFIAN: return "zipfian";
+    }
+    return "unknown";
+}
+
+// Ключ по номеру: порядок ключей совпадает с порядком номеров
+// Дерево содержит чётные номера, нечётные - гарантированные промахи
+template <typename T>
+struct KeyTraits;
+
+template <>
+struct KeyTraits<int> {
+    static constexpr const char* NAME = "int";
+    static int Make(size_t rank) { return static_cast<int>(rank); }
+};
+
+template <>
+struct KeyTraits<float> {
+    static constexpr const char* NAME = "float";
+    // Целые до 2^24 представимы во float точно
+    static float Make(size_t rank) { return static_cast<float>(rank); }
+};
+
+template <>
+struct KeyTraits<double> {
+    static constexpr const char* NAME = "double";
+    static double Make(size_t rank) { return static_cast<double>(rank) * 0.5; }
+};
+
+template <>
+struct KeyTraits<std::string> {
+    static constexpr const char* NAME = "string";
+    // Общий префикс и дополнение нулями: лексикографический порядок = порядок номеров
+    static std::string Make(size_t rank) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "key-%010zu", rank);
+        return buffer;
+    }
+};
+
+template <>
+struct KeyTraits<std::complex<double>> {
+    static constexpr const char* NAME = "complex";
+    static std::complex<double> Make(size_t rank) {
+        return {static_cast<double>(rank), -static_cast<double>(rank % 7)};
+    }
+};
+
+// Номера ключей в порядке обращений для распределения
+inline std::vector<size_t> MakeRanks(Distribution distribution, size_t n) {
+    std::vector<size_t> ranks(n);
+    std::iota(ranks.begin(), ranks.end(), size_t(0));
+    std::mt19937_64 gen(BENCHMARK_SEED + static_cast<unsigned>(distribution));
+    if (distribution == Distribution::SORTED) {
+        return ranks;
+    }
+    std::shuffle(ranks.begin(), ranks.end(), gen);
+    if (distribution == Distribution::SHUFFLED) {
+        return ranks;
+    }
+    // Ципф: i-й по популярности ключ выбирается с вероятностью ~ 1 / (i + 1)^s;
+    // популярность -> номер через перестановку, чтобы горячие ключи не шли подряд
+    std::vector<double> cumulative(n);
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        total += 1.0 / std::pow(static_cast<double>(i + 1), ZIPF_EXPONENT);
+        cumulative[i] = total;
+    }
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    std::vector<size_t> draws(n);
+    for (size_t& draw : draws) {
+        size_t popularity = static_cast<size_t>(
+            std::lower_bound(cumulative.begin(), cumulative.end(), uniform(gen)) - cumulative.begin());
+        draw = ranks[std::min(popularity, n - 1)];
+    }
+    return draws;
+}
+
+// Разбор --tree_sizes=1000,100000 (аргумент удаляется из argv до Google Benchmark)
+inline std::vector<size_t> TakeSizes(int& argc, char** argv) {
+    std::vector<size_t> sizes = {1000, 100000};
+    const std::string prefix = "--tree_sizes=";
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        sizes.clear();
+        std::stringstream list(argument.substr(prefix.size()));
+        std::string item;
+        while (std::getline(list, item, ',')) {
+            sizes.push_back(static_cast<size_t>(std::stoull(item)));
+        }
+        std::copy(argv + i + 1, argv + argc, argv + i);
+        --argc;
+        --i;
+    }
+    return sizes;
+}
+#endif
@@ -0,0 +1,860 @@
+#include "binary_tree.h"
+#include "mapped_tree.h"
+#include "block_tree.h"
+#include "concurrent_tree.h"
+#include "lockfree_tree.h"
+#include "persistent_tree.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <complex>
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+// Сравнительные замеры: каждая функция сопоставляет реализацию с альтернативой
+// и пишет таблицу в свой performance_*.csv. Регрессионный набор по всем операциям - benchmark.cpp
+
+// Тест на отсортированных данных: высота и время без балансировки и с AVL
+void performance_test_sorted() {
+    ofstream out("performance_sorted.csv");
+    out << "policy,n,height,insert_time,find_time,remove_time\n";
+
+    const pair<BalancePolicy, const char*> policies[] = {
+        {BalancePolicy::NONE, "none"},
+        {BalancePolicy::AVL, "avl"}
+    };
+    for (const auto& [policy, name] : policies) {
+        // Без балансировки вставка отсортированных данных квадратична - ограничиваем n
+        const int max_n = policy == BalancePolicy::NONE ? 10000 : 1000000;
+        for (int n = 1000; n <= max_n; n *= 10) {
+            BinaryTree<int> tree(policy);
+
+            auto start = high_resolution_clock::now();
+            for (int i = 1; i <= n; ++i) {
+                tree.Insert(i);
+            }
+            auto insert_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+            start = high_resolution_clock::now();
+            for (int i = 1; i <= n; i += n / 1000) {
+                tree.Contains(i);
+            }
+            auto find_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+            size_t height = tree.Height();
+
+            start = high_resolution_clock::now();
+            for (int i = 1; i <= n; i += n / 1000) {
+                tree.Remove(i);
+            }
+            auto remove_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+            out << name << "," << n << "," << height << "," << insert_time << "," << find_time << "," << remove_time << "\n";
+            cout << name << ": n = " << n << ", height = " << height
+                 << ", insert " << insert_time << " us, 1000 finds " << find_time
+                 << " us, 1000 removes " << remove_time << " us" << endl;
+        }
+    }
+}
+
+// Сравнение задержки поиска: Contains (промах = исключение) и TryContains (промах = false)
+void performance_test_lookup() {
+    ofstream out("performance_lookup.csv");
+    out << "method,probe,ns_per_lookup\n";
+
+    const int n = 100000;
+    const int probes = 100000;
+    BinaryTree<int> tree;
+    vector<int> elements(n);
+    for (int i = 0; i < n; ++i) {
+        elements[i] = 2 * (i + 1); // В дереве только чётные - нечётные гарантированно промахи
+    }
+    mt19937 gen(42);
+    shuffle(elements.begin(), elements.end(), gen);
+    for (int value : elements) {
+        tree.Insert(value);
+    }
+
+    vector<int> hits(probes), misses(probes);
+    for (int i = 0; i < probes; ++i) {
+        hits[i] = elements[gen() % n];
+        misses[i] = hits[i] + 1;
+    }
+
+    auto run = [&](const char* method, const char* probe, const vector<int>& keys, auto&& lookup) {
+        size_t found = 0; // Результат используется, чтобы поиск не был выброшен оптимизатором
+        auto start = high_resolution_clock::now();
+        for (int key : keys) {
+            found += lookup(key) ? 1 : 0;
+        }
+        auto total = duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+        double per_lookup = static_cast<double>(total) / keys.size();
+        out << method << "," << probe << "," << per_lookup << "\n";
+        cout << method << " " << probe << ": " << per_lookup << " ns/lookup (found " << found << ")" << endl;
+    };
+    auto throwing = [&tree](int key) {
+        try {
+            return tree.Contains(key);
+        } catch (const TreeException&) {
+            return false;
+        }
+    };
+    auto non_throwing = [&tree](int key) { return tree.TryContains(key); };
+
+    run("Contains", "hit", hits, throwing);
+    run("Contains", "miss", misses, throwing);
+    run("TryContains", "hit", hits, non_throwing);
+    run("TryContains", "miss", misses, non_throwing);
+}
+
+// Сравнение обхода через std::function (Traverse) и шаблонного обхода (ForEach)
+template <typename T, typename MakeKey, typename Measure>
+void traversal_case(ofstream& out, const char* type_name, MakeKey make_key, Measure measure) {
+    const int n = 200000;
+    const int rounds = 10;
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    mt19937 gen(7);
+    shuffle(order.begin(), order.end(), gen);
+    BinaryTree<T> tree;
+    for (int i : order) {
+        tree.Insert(make_key(i));
+    }
+
+    size_t checksum = 0; // Результат используется, чтобы обход не был выброшен оптимизатором
+    auto start = high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        tree.Traverse(TraversalType::IN_ORDER, [&checksum, &measure](T value) { checksum += measure(value); });
+    }
+    auto function_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        tree.template ForEach<TraversalType::IN_ORDER>([&checksum, &measure](const T& value) { checksum += measure(value); });
+    }
+    auto template_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    out << type_name << "," << n << "," << function_time << "," << template_time << "\n";
+    cout << type_name << ": std::function " << function_time << " us, template " << template_time
+         << " us (" << rounds << " in-order passes over " << n << " keys, checksum " << checksum << ")" << endl;
+}
+
+void performance_test_traversal() {
+    ofstream out("performance_traversal.csv");
+    out << "type,n,function_time,template_time\n";
+    traversal_case<int>(out, "int", [](int i) { return i; }, [](int v) { return static_cast<size_t>(v); });
+    traversal_case<string>(out, "string",
+        [](int i) { return "key-with-a-long-common-prefix-" + to_string(i); },
+        [](const string& v) { return v.size(); });
+}
+
+// Слияние двух деревьев по 10^6 значений: повторные Insert против линейного merge
+void performance_test_merge() {
+    const int n = 1000000;
+    mt19937 gen(11);
+    uniform_int_distribution<int> dist(0, 4 * n); // Около четверти значений общие
+    BinaryTree<int> first, second;
+    for (int i = 0; i < n; ++i) {
+        first.Insert(dist(gen));
+        second.Insert(dist(gen));
+    }
+    cout << "Merging trees of " << first.Size() << " and " << second.Size() << " values" << endl;
+
+    // Прежний способ: копия и вставка каждого значения второго дерева
+    auto start = high_resolution_clock::now();
+    BinaryTree<int> inserted = first;
+    second.ForEach<TraversalType::IN_ORDER>([&inserted](const int& val) { inserted.Insert(val); });
+    auto insert_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "Copy + Insert: " << insert_time << " ms, size " << inserted.Size()
+         << ", height " << inserted.Height() << endl;
+
+    start = high_resolution_clock::now();
+    BinaryTree<int> merged = first.merge(second);
+    auto merge_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "merge: " << merge_time << " ms, size " << merged.Size() << ", height " << merged.Height() << endl;
+
+    start = high_resolution_clock::now();
+    size_t common = first.setIntersection(second).Size();
+    auto intersection_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "setIntersection: " << intersection_time << " ms, size " << common << endl;
+
+    start = high_resolution_clock::now();
+    size_t rest = first.setDifference(second).Size();
+    auto difference_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "setDifference: " << difference_time << " ms, size " << rest << endl;
+}
+
+// Холодная загрузка 10^6 значений: Insert по одному против массовой загрузки
+void performance_test_bulk_load() {
+    const int n = 1000000;
+    vector<int> elements(n);
+    iota(elements.begin(), elements.end(), 1);
+    mt19937 gen(5);
+    shuffle(elements.begin(), elements.end(), gen);
+
+    auto start = high_resolution_clock::now();
+    BinaryTree<int> inserted;
+    for (int value : elements) {
+        inserted.Insert(value);
+    }
+    auto insert_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "Insert x " << n << ": " << insert_time << " ms, height " << inserted.Height() << endl;
+
+    start = high_resolution_clock::now();
+    BinaryTree<int> from_range = BinaryTree<int>::FromRange(elements.begin(), elements.end());
+    auto range_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "FromRange: " << range_time << " ms, height " << from_range.Height() << endl;
+
+    start = high_resolution_clock::now();
+    BinaryTree<int> from_range_parallel = BinaryTree<int>::FromRange(elements.begin(), elements.end(), true);
+    auto parallel_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "FromRange (parallel sort): " << parallel_time << " ms, height " << from_range_parallel.Height() << endl;
+
+    sort(elements.begin(), elements.end());
+    start = high_resolution_clock::now();
+    BinaryTree<int> from_sorted = BinaryTree<int>::FromSorted(elements.begin(), elements.end());
+    auto sorted_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "FromSorted: " << sorted_time << " ms, height " << from_sorted.Height() << endl;
+}
+
+// Текстовый и двоичный форматы: размер и время на 10^6 узлов
+template <typename T, typename MakeKey>
+void serialization_case(ofstream& out, const char* type_name, MakeKey make_key) {
+    const int n = 1000000;
+    vector<T> keys;
+    keys.reserve(n);
+    mt19937 gen(3);
+    for (int i = 0; i < n; ++i) {
+        keys.push_back(make_key(i));
+    }
+    shuffle(keys.begin(), keys.end(), gen);
+    BinaryTree<T> tree;
+    for (const T& key : keys) {
+        tree.Insert(key);
+    }
+
+    auto start = high_resolution_clock::now();
+    string text = tree.serialize(TraversalType::PRE_ORDER);
+    auto text_write = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    BinaryTree<T> from_text;
+    from_text.deserialize(text, TraversalType::PRE_ORDER);
+    auto text_read = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    string binary = tree.serializeBinary();
+    auto binary_write = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    BinaryTree<T> from_binary;
+    from_binary.deserializeBinary(binary);
+    auto binary_read = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    // Потоковые варианты через файл: в памяти только буферы фиксированного размера
+    string path = string("serialization_") + type_name + ".tmp";
+    start = high_resolution_clock::now();
+    {
+        ofstream file(path, ios::binary);
+        tree.serialize(file, TraversalType::PRE_ORDER);
+    }
+    auto stream_write = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    BinaryTree<T> from_stream;
+    {
+        ifstream file(path, ios::binary);
+        from_stream.deserialize(file, TraversalType::PRE_ORDER);
+    }
+    auto stream_read = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    start = high_resolution_clock::now();
+    {
+        ofstream file(path, ios::binary);
+        tree.serializeBinary(file);
+    }
+    auto binary_stream_write = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    BinaryTree<T> from_binary_stream;
+    {
+        ifstream file(path, ios::binary);
+        from_binary_stream.deserializeBinary(file);
+    }
+    auto binary_stream_read = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    remove(path.c_str());
+
+    out << type_name << ",text," << text.size() << "," << text_write << "," << text_read << "\n";
+    out << type_name << ",binary," << binary.size() << "," << binary_write << "," << binary_read << "\n";
+    out << type_name << ",text_stream," << text.size() << "," << stream_write << "," << stream_read << "\n";
+    out << type_name << ",binary_stream," << binary.size() << "," << binary_stream_write << "," << binary_stream_read << "\n";
+    cout << type_name << ": text " << text.size() << " bytes (" << text_write << " / " << text_read
+         << " ms), binary " << binary.size() << " bytes (" << binary_write << " / " << binary_read << " ms)"
+         << (from_binary.Size() == tree.Size() ? "" : " SIZE MISMATCH") << endl;
+    cout << type_name << ": text stream " << stream_write << " / " << stream_read << " ms, binary stream "
+         << binary_stream_write << " / " << binary_stream_read << " ms"
+         << (from_stream.Size() == tree.Size() && from_binary_stream.Size() == tree.Size() ? "" : " SIZE MISMATCH")
+         << endl;
+}
+
+void performance_test_serialization() {
+    ofstream out("performance_serialization.csv");
+    out << "type,format,bytes,write_time,read_time\n";
+    serialization_case<int>(out, "int", [](int i) { return i; });
+    serialization_case<double>(out, "double", [](int i) { return i * 0.5; });
+    serialization_case<string>(out, "string", [](int i) { return "key-" + to_string(i); });
+}
+
+// Запуск с образа в памяти и с двоичного файла: время открытия и поиска на n узлах
+template <typename T, typename MakeKey>
+void mapped_case(ofstream& out, const char* type_name, int n, MakeKey make_key) {
+    vector<T> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        keys.push_back(make_key(i));
+    }
+    mt19937 gen(4);
+    shuffle(keys.begin(), keys.end(), gen);
+    BinaryTree<T> tree(BalancePolicy::AVL);
+    for (const T& key : keys) {
+        tree.Insert(key);
+    }
+    string image_path = string("mapped_") + type_name + ".img";
+    string binary_path = string("mapped_") + type_name + ".bin";
+    auto start = high_resolution_clock::now();
+    tree.ExportImage(image_path);
+    auto export_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    {
+        ofstream file(binary_path, ios::binary);
+        tree.serializeBinary(file);
+    }
+
+    start = high_resolution_clock::now();
+    MappedBinaryTree<T> mapped(image_path);
+    auto open_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    BinaryTree<T> loaded;
+    {
+        ifstream file(binary_path, ios::binary);
+        loaded.deserializeBinary(file);
+    }
+    auto load_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+    shuffle(keys.begin(), keys.end(), gen);
+    size_t found = 0;
+    start = high_resolution_clock::now();
+    for (const T& key : keys) {
+        found += mapped.Contains(key);
+    }
+    auto mapped_lookup = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    for (const T& key : keys) {
+        found += loaded.TryContains(key);
+    }
+    auto tree_lookup = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    remove(image_path.c_str());
+    remove(binary_path.c_str());
+
+    out << type_name << "," << n << "," << export_time << "," << open_time << "," << load_time << ","
+        << mapped_lookup << "," << tree_lookup << "\n";
+    cout << type_name << " n=" << n << ": open image " << open_time << " us vs load binary " << load_time
+         << " us; " << n << " lookups mapped " << mapped_lookup << " ms vs tree " << tree_lookup << " ms"
+         << (found == 2 * static_cast<size_t>(n) ? "" : " LOOKUP MISMATCH") << endl;
+}
+
+void performance_test_mapped() {
+    ofstream out("performance_mapped.csv");
+    out << "type,n,export_time_ms,open_time_us,binary_load_time_us,mapped_lookup_ms,tree_lookup_ms\n";
+    for (int n : {100000, 1000000}) {
+        mapped_case<int>(out, "int", n, [](int i) { return i; });
+        mapped_case<double>(out, "double", n, [](int i) { return i * 0.5; });
+        mapped_case<string>(out, "string", n, [](int i) { return "key-" + to_string(i); });
+    }
+}
+
+// Случайные пробы: дерево с указателями (Contains) против снимка Freeze()
+// Половина проб - попадания, половина - промахи (нечётные ключи отсутствуют)
+void frozen_case(ofstream& out, int n, bool random_inserts) {
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i) {
+        keys[i] = 2 * i;
+    }
+    mt19937 gen(5);
+    shuffle(keys.begin(), keys.end(), gen);
+    BinaryTree<int> tree(BalancePolicy::AVL);
+    if (random_inserts) {
+        for (int key : keys) {
+            tree.Insert(key);
+        }
+    } else {
+        tree = BinaryTree<int>::FromRange(keys.begin(), keys.end(), true, BalancePolicy::AVL);
+    }
+
+    auto start = high_resolution_clock::now();
+    FrozenBinaryTree<int> frozen = tree.Freeze();
+    auto freeze_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    const int probes = 1000000;
+    vector<int> queries(probes);
+    uniform_int_distribution<int> dist(0, 2 * n - 1);
+    for (int& query : queries) {
+        query = dist(gen);
+    }
+
+    size_t tree_found = 0;
+    start = high_resolution_clock::now();
+    for (int query : queries) {
+        try {
+            tree_found += tree.Contains(query);
+        } catch (const TreeException&) {
+        }
+    }
+    auto contains_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    size_t try_found = 0;
+    start = high_resolution_clock::now();
+    for (int query : queries) {
+        try_found += tree.TryContains(query);
+    }
+    auto try_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    size_t frozen_found = 0;
+    start = high_resolution_clock::now();
+    for (int query : queries) {
+        frozen_found += frozen.TryContains(query);
+    }
+    auto frozen_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    out << n << "," << (random_inserts ? "random" : "bulk") << "," << freeze_time << "," << contains_time << ","
+        << try_time << "," << frozen_time << "\n";
+    cout << "n=" << n << (random_inserts ? " (random inserts)" : " (bulk load)") << ": freeze " << freeze_time
+         << " ms; " << probes << " probes: Contains (throws on miss) " << contains_time << " ms, TryContains " << try_time
+         << " ms, frozen " << frozen_time << " ms"
+         << (tree_found == try_found && try_found == frozen_found ? "" : " RESULT MISMATCH") << endl;
+}
+
+void performance_test_frozen() {
+    ofstream out("performance_frozen.csv");
+    out << "n,build,freeze_ms,contains_ms,try_contains_ms,frozen_ms\n";
+    frozen_case(out, 100000, true);
+    frozen_case(out, 1000000, true);
+    frozen_case(out, 10000000, false);
+}
+
+// Дерево с многоключевыми узлами против BinaryTree (AVL): вставка и поиск n случайных ключей
+template <typename T, typename MakeKey>
+void block_case(ofstream& out, const char* type_name, int n, MakeKey make_key) {
+    vector<T> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        keys.push_back(make_key(2 * i)); // Нечётные - промахи
+    }
+    mt19937 gen(7);
+    shuffle(keys.begin(), keys.end(), gen);
+    vector<T> queries;
+    queries.reserve(n);
+    uniform_int_distribution<int> dist(0, 2 * n - 1);
+    for (int i = 0; i < n; ++i) {
+        queries.push_back(make_key(dist(gen)));
+    }
+
+    auto measure = [&](auto& tree, const char* variant) {
+        auto start = high_resolution_clock::now();
+        for (const T& key : keys) {
+            tree.Insert(key);
+        }
+        auto insert_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        size_t found = 0;
+        start = high_resolution_clock::now();
+        for (const T& query : queries) {
+            found += tree.TryContains(query);
+        }
+        auto lookup_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        out << type_name << "," << variant << "," << n << "," << tree.Height() << "," << insert_time << ","
+            << lookup_time << "\n";
+        cout << "  " << type_name << " " << variant << ": height " << tree.Height() << ", insert " << insert_time
+             << " ms, lookup " << lookup_time << " ms (" << found << " hits)" << endl;
+    };
+
+    BinaryTree<T> avl(BalancePolicy::AVL);
+    measure(avl, "binary_avl");
+    BlockTree<T, false> scalar_blocks;
+    measure(scalar_blocks, "block_scalar");
+    BlockTree<T> simd_blocks;
+    measure(simd_blocks, simd_search::BACKEND);
+}
+
+void performance_test_block() {
+    ofstream out("performance_block.csv");
+    out << "type,variant,n,height,insert_ms,lookup_ms\n";
+    cout << "Block node search backend: " << simd_search::BACKEND << endl;
+    block_case<int>(out, "int", 1000000, [](int i) { return i; });
+    block_case<float>(out, "float", 1000000, [](int i) { return static_cast<float>(i); });
+    block_case<double>(out, "double", 1000000, [](int i) { return i * 0.5; });
+}
+
+// Пакетный поиск против цикла Contains: пропускная способность по размерам пакета
+void performance_test_batch() {
+    ofstream out("performance_batch.csv");
+    out << "n,batch,loop_contains_mlps,batch_mlps,batch_sorted_mlps\n";
+    const int n = 1000000;
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i) {
+        keys[i] = 2 * i;
+    }
+    mt19937 gen(9);
+    shuffle(keys.begin(), keys.end(), gen);
+    BinaryTree<int> tree(BalancePolicy::AVL);
+    for (int key : keys) {
+        tree.Insert(key);
+    }
+
+    // Только попадания, чтобы Contains не бросал исключений
+    const size_t total = 1 << 20;
+    vector<int> queries(total);
+    uniform_int_distribution<int> dist(0, n - 1);
+    for (int& query : queries) {
+        query = keys[dist(gen)];
+    }
+    unique_ptr<bool[]> results(new bool[total]);
+
+    auto lookups_per_us = [total](long long micros) { return micros > 0 ? static_cast<double>(total) / micros : 0.0; };
+    for (size_t batch : {size_t(1) << 10, size_t(1) << 12, size_t(1) << 14, size_t(1) << 16}) {
+        auto start = high_resolution_clock::now();
+        size_t found = 0;
+        for (int query : queries) {
+            found += tree.Contains(query);
+        }
+        auto loop_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+
+        start = high_resolution_clock::now();
+        for (size_t offset = 0; offset < total; offset += batch) {
+            tree.ContainsBatch(queries.data() + offset, batch, results.get() + offset);
+        }
+        auto batch_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        size_t batch_found = count(results.get(), results.get() + total, true);
+
+        start = high_resolution_clock::now();
+        for (size_t offset = 0; offset < total; offset += batch) {
+            tree.ContainsBatch(queries.data() + offset, batch, results.get() + offset, true);
+        }
+        auto sorted_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        size_t sorted_found = count(results.get(), results.get() + total, true);
+
+        out << n << "," << batch << "," << lookups_per_us(loop_time) << "," << lookups_per_us(batch_time) << ","
+            << lookups_per_us(sorted_time) << "\n";
+        cout << "batch " << batch << ": Contains loop " << lookups_per_us(loop_time) << " M/s, ContainsBatch "
+             << lookups_per_us(batch_time) << " M/s, sorted " << lookups_per_us(sorted_time) << " M/s"
+             << (found == total && batch_found == total && sorted_found == total ? "" : " RESULT MISMATCH") << endl;
+    }
+}
+
+// Масштабирование parallelMap/parallelWhere от 1 до N потоков против последовательных map/where
+void performance_test_parallel() {
+    ofstream out("performance_parallel.csv");
+    out << "n,threads,map_ms,where_ms\n";
+    const int n = 2000000;
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i) {
+        keys[i] = i;
+    }
+    shuffle(keys.begin(), keys.end(), mt19937(11));
+    BinaryTree<int> tree(BalancePolicy::AVL);
+    for (int key : keys) {
+        tree.Insert(key);
+    }
+    // Функции с заметной работой на значение, чтобы было что распараллеливать
+    auto mapper = [](int x) {
+        unsigned h = static_cast<unsigned>(x);
+        for (int round = 0; round < 16; ++round) {
+            h = h * 2654435761u + 0x9e3779b9u;
+        }
+        return static_cast<int>(h >> 1);
+    };
+    auto predicate = [mapper](int x) { return (mapper(x) & 3) == 0; };
+
+    auto start = high_resolution_clock::now();
+    BinaryTree<int> serial_map = tree.map(mapper);
+    auto serial_map_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    BinaryTree<int> serial_where = tree.where(predicate);
+    auto serial_where_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    out << n << ",serial," << serial_map_time << "," << serial_where_time << "\n";
+    cout << "serial: map " << serial_map_time << " ms, where " << serial_where_time << " ms" << endl;
+
+    // 1, 2, 4, ... и ровно все ядра
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(cores);
+    for (unsigned threads : thread_counts) {
+        start = high_resolution_clock::now();
+        BinaryTree<int> parallel_map = tree.parallelMap(mapper, threads);
+        auto map_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        start = high_resolution_clock::now();
+        BinaryTree<int> parallel_where = tree.parallelWhere(predicate, threads);
+        auto where_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        out << n << "," << threads << "," << map_time << "," << where_time << "\n";
+        cout << threads << " threads: parallelMap " << map_time << " ms (height " << parallel_map.Height()
+             << " vs " << serial_map.Height() << "), parallelWhere " << where_time << " ms"
+             << (parallel_map.Size() == serial_map.Size() && parallel_where.Size() == serial_where.Size()
+                     ? "" : " SIZE MISMATCH")
+             << endl;
+    }
+}
+
+// Пропускная способность при долях чтения 100/0, 95/5 и 50/50:
+// дерево с блокировкой по узлам против BinaryTree под одним общим мьютексом
+template <typename Tree, typename Read, typename Write>
+double concurrent_throughput(Tree& tree, unsigned threads, int read_percent, Read read, Write write) {
+    const int ops_per_thread = 200000;
+    const int key_range = 200000;
+    vector<thread> workers;
+    auto start = high_resolution_clock::now();
+    for (unsigned id = 0; id < threads; ++id) {
+        workers.emplace_back([&, id]() {
+            mt19937 gen(200 + id);
+            for (int op = 0; op < ops_per_thread; ++op) {
+                int key = static_cast<int>(gen() % key_range);
+                if (static_cast<int>(gen() % 100) < read_percent) {
+                    read(tree, key);
+                } else {
+                    write(tree, key, (gen() & 1) != 0);
+                }
+            }
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    auto micros = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    return micros > 0 ? static_cast<double>(ops_per_thread) * threads / micros : 0.0;
+}
+
+void performance_test_concurrent() {
+    ofstream out("performance_concurrent.csv");
+    out << "threads,read_percent,global_mutex_mops,lock_coupling_mops\n";
+    vector<int> initial(100000);
+    mt19937 gen(12);
+    for (int& key : initial) {
+        key = static_cast<int>(gen() % 200000);
+    }
+
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    for (unsigned threads : {1u, 4u, max(4u, cores)}) {
+        for (int read_percent : {100, 95, 50}) {
+            BinaryTree<int> locked_tree;
+            mutex tree_mutex;
+            ConcurrentBinaryTree<int> coupled_tree;
+            for (int key : initial) {
+                locked_tree.Insert(key);
+                coupled_tree.Insert(key);
+            }
+            double global = concurrent_throughput(
+                locked_tree, threads, read_percent,
+                [&tree_mutex](BinaryTree<int>& tree, int key) {
+                    lock_guard<mutex> lock(tree_mutex);
+                    tree.TryContains(key);
+                },
+                [&tree_mutex](BinaryTree<int>& tree, int key, bool insert) {
+                    lock_guard<mutex> lock(tree_mutex);
+                    if (insert) {
+                        tree.Insert(key);
+                    } else if (tree.TryContains(key)) {
+                        tree.Remove(key);
+                    }
+                });
+            double coupled = concurrent_throughput(
+                coupled_tree, threads, read_percent,
+                [](ConcurrentBinaryTree<int>& tree, int key) { tree.TryContains(key); },
+                [](ConcurrentBinaryTree<int>& tree, int key, bool insert) {
+                    if (insert) {
+                        tree.Insert(key);
+                    } else {
+                        tree.Remove(key);
+                    }
+                });
+            out << threads << "," << read_percent << "," << global << "," << coupled << "\n";
+            cout << threads << " threads, " << read_percent << "% reads: global mutex " << global
+                 << " Mops/s, lock coupling " << coupled << " Mops/s" << endl;
+        }
+        if (cores <= 4 && threads == 4) {
+            break; // Третья строка совпала бы со второй
+        }
+    }
+}
+
+// Снимки на каждую пачку запросов: копирование BinaryTree (O(n)) против версии PersistentBinaryTree (O(1))
+// Пачка - 100 вставок, затем снимок для согласованного чтения
+void performance_test_persistent() {
+    ofstream out("performance_persistent.csv");
+    out << "size,copy_snapshot_us,persistent_snapshot_us,insert_batch_copy_us,insert_batch_persistent_us\n";
+    const int batches = 50;
+    const int batch_size = 100;
+    for (int size : {10000, 100000, 1000000}) {
+        vector<int> keys(size);
+        mt19937 gen(14);
+        for (int& key : keys) {
+            key = static_cast<int>(gen());
+        }
+        BinaryTree<int> tree(BalancePolicy::AVL);
+        for (int key : keys) {
+            tree.Insert(key);
+        }
+        PersistentBinaryTree<int> version = tree.Persist();
+
+        long long copy_snapshot = 0;
+        long long copy_insert = 0;
+        bool sizes_ok = true;
+        for (int batch = 0; batch < batches; ++batch) {
+            auto start = high_resolution_clock::now();
+            for (int i = 0; i < batch_size; ++i) {
+                tree.Insert(static_cast<int>(gen()));
+            }
+            auto middle = high_resolution_clock::now();
+            BinaryTree<int> snapshot(tree);
+            auto finish = high_resolution_clock::now();
+            sizes_ok = sizes_ok && snapshot.Size() == tree.Size();
+            copy_insert += duration_cast<microseconds>(middle - start).count();
+            copy_snapshot += duration_cast<microseconds>(finish - middle).count();
+        }
+
+        long long persistent_snapshot = 0;
+        long long persistent_insert = 0;
+        vector<PersistentBinaryTree<int>> snapshots;
+        vector<size_t> snapshot_sizes;
+        for (int batch = 0; batch < batches; ++batch) {
+            auto start = high_resolution_clock::now();
+            for (int i = 0; i < batch_size; ++i) {
+                version = version.Insert(static_cast<int>(gen()));
+            }
+            auto middle = high_resolution_clock::now();
+            snapshots.push_back(version); // Снимки живут одновременно - старые версии остаются читаемыми
+            auto finish = high_resolution_clock::now();
+            persistent_insert += duration_cast<microseconds>(middle - start).count();
+            persistent_snapshot += duration_cast<nanoseconds>(finish - middle).count();
+            snapshot_sizes.push_back(version.Size());
+        }
+        // Последующие вставки не меняют ранее сохранённые версии
+        for (size_t i = 0; i < snapshots.size(); ++i) {
+            sizes_ok = sizes_ok && snapshots[i].Size() == snapshot_sizes[i];
+        }
+
+        double copy_us = static_cast<double>(copy_snapshot) / batches;
+        double persistent_us = static_cast<double>(persistent_snapshot) / batches / 1000.0;
+        double copy_batch = static_cast<double>(copy_insert) / batches;
+        double persistent_batch = static_cast<double>(persistent_insert) / batches;
+        out << size << "," << copy_us << "," << persistent_us << "," << copy_batch << "," << persistent_batch << "\n";
+        cout << size << " values: snapshot " << copy_us << " us (copy) vs " << persistent_us
+             << " us (persistent), 100 inserts " << copy_batch << " us vs " << persistent_batch << " us"
+             << (sizes_ok ? "" : " SIZE MISMATCH") << endl;
+    }
+}
+
+// Масштабирование по потокам: неблокирующее дерево против дерева с блокировкой по узлам
+// Доли чтения 100/0, 90/10 и 50/50 (запись - вставка или удаление случайного ключа)
+void performance_test_lockfree() {
+    ofstream out("performance_lockfree.csv");
+    out << "threads,read_percent,lock_coupling_mops,lock_free_mops\n";
+    vector<int> initial(100000);
+    mt19937 gen(13);
+    for (int& key : initial) {
+        key = static_cast<int>(gen() % 200000);
+    }
+
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    vector<unsigned> thread_counts = {1, 2, 4, 8};
+    if (cores > 8) {
+        thread_counts.push_back(cores);
+    }
+    for (unsigned threads : thread_counts) {
+        for (int read_percent : {100, 90, 50}) {
+            ConcurrentBinaryTree<int> coupled_tree;
+            LockFreeBinaryTree<int> lockfree_tree;
+            for (int key : initial) {
+                coupled_tree.Insert(key);
+                lockfree_tree.Insert(key);
+            }
+            auto read = [](auto& tree, int key) { tree.TryContains(key); };
+            auto write = [](auto& tree, int key, bool insert) {
+                if (insert) {
+                    tree.Insert(key);
+                } else {
+                    tree.Remove(key);
+                }
+            };
+            double coupled = concurrent_throughput(coupled_tree, threads, read_percent, read, write);
+            double lockfree = concurrent_throughput(lockfree_tree, threads, read_percent, read, write);
+            out << threads << "," << read_percent << "," << coupled << "," << lockfree << "\n";
+            cout << threads << " threads, " << read_percent << "% reads: lock coupling " << coupled
+                 << " Mops/s, lock-free " << lockfree << " Mops/s" << endl;
+        }
+    }
+}
+
+int main() {
+    cout << "Running sorted input performance tests...\n";
+    performance_test_sorted();
+    cout << "Results saved to performance_sorted.csv\n";
+
+    cout << "Running lookup latency tests...\n";
+    performance_test_lookup();
+    cout << "Results saved to performance_lookup.csv\n";
+
+    cout << "Running traversal performance tests...\n";
+    performance_test_traversal();
+    cout << "Results saved to performance_traversal.csv\n";
+
+    cout << "Running merge performance tests...\n";
+    performance_test_merge();
+
+    cout << "Running bulk load performance tests...\n";
+    performance_test_bulk_load();
+
+    cout << "Running serialization format tests...\n";
+    performance_test_serialization();
+    cout << "Results saved to performance_serialization.csv\n";
+
+    cout << "Running mapped image tests...\n";
+    performance_test_mapped();
+    cout << "Results saved to performance_mapped.csv\n";
+
+    cout << "Running frozen snapshot tests...\n";
+    performance_test_frozen();
+    cout << "Results saved to performance_frozen.csv\n";
+
+    cout << "Running block tree tests...\n";
+    performance_test_block();
+    cout << "Results saved to performance_block.csv\n";
+
+    cout << "Running batch lookup tests...\n";
+    performance_test_batch();
+    cout << "Results saved to performance_batch.csv\n";
+
+    cout << "Running parallel map/where tests...\n";
+    performance_test_parallel();
+    cout << "Results saved to performance_parallel.csv\n";
+
+    cout << "Running concurrent tree benchmark...\n";
+    performance_test_concurrent();
+    cout << "Results saved to performance_concurrent.csv\n";
+
+    cout << "Running persistent tree benchmark...\n";
+    performance_test_persistent();
+    cout << "Results saved to performance_persistent.csv\n";
+
+    cout << "Running lock-free tree benchmark...\n";
+    performance_test_lockfree();
+    cout << "Results saved to performance_lockfree.csv\n";
+
+    return 0;
+}
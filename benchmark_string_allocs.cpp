@@ -0,0 +1,187 @@
+#include "binary_tree.h"
+#include "benchmark_inputs.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Выделения памяти на ключ для строковых ключей (Google Benchmark)
+// Отдельная программа: глобальные operator new/delete заменены счётчиком, и в общем наборе
+// (lab4_benchmark) атомарный счётчик на каждом выделении искажал бы замеры времени.
+// Имя случая: StringAllocs/операция/n, счётчик allocs_per_key; флаги - как у lab4_benchmark
+
+// Счётчик выделений динамической памяти во всей программе
+// Заменены все формы без выравнивания (обычные, массивы, nothrow, с размером), чтобы каждая
+// пара new/delete шла через malloc/free; разность показаний берётся до и после замеряемых операций
+std::atomic<size_t> allocation_count{0};
+
+namespace {
+
+void* CountedAllocate(size_t size) noexcept {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* CountedAllocateOrThrow(size_t size) {
+    if (void* memory = CountedAllocate(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    return CountedAllocateOrThrow(size);
+}
+
+void* operator new[](size_t size) {
+    return CountedAllocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+// Выделения памяти для длинных строковых ключей (не помещаются в SSO-буфер строки)
+// Счётчик allocs_per_key - выделений на один ключ внутри замера; узлы выделяются блоками пула,
+// поэтому почти все выделения - копии строк
+
+// Ключ 64 символа с тем же порядком, что у KeyTraits<std::string>
+std::string LongKey(size_t rank) {
+    return KeyTraits<std::string>::Make(rank) + std::string(50, '.');
+}
+
+const std::vector<std::string>& LongKeys(size_t n) {
+    static std::map<size_t, std::vector<std::string>> cache;
+    std::vector<std::string>& keys = cache[n];
+    if (keys.empty()) {
+        for (size_t rank : MakeRanks(Distribution::SHUFFLED, n)) {
+            keys.push_back(LongKey(2 * rank));
+        }
+    }
+    return keys;
+}
+
+enum class StringOperation {
+    INSERT_COPY, // Insert(const T&)
+    INSERT_MOVE, // Insert(T&&), ключи скопированы вне замера
+    EMPLACE,     // Emplace(const char*) - строка строится сразу для узла
+    MAP,         // map с тождественным преобразованием
+    REMOVE       // Remove всех ключей
+};
+
+void StringAllocs(benchmark::State& state, size_t n, StringOperation operation) {
+    const std::vector<std::string>& keys = LongKeys(n);
+    BinaryTree<std::string> source(BalancePolicy::AVL);
+    for (const std::string& key : keys) {
+        source.Insert(key);
+    }
+    size_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto tree = std::make_unique<BinaryTree<std::string>>(BalancePolicy::AVL);
+        std::vector<std::string> movable;
+        if (operation == StringOperation::INSERT_MOVE) {
+            movable = keys;
+        }
+        if (operation == StringOperation::REMOVE) {
+            *tree = source;
+        }
+        BinaryTree<std::string> mapped;
+        size_t before = allocation_count.load(std::memory_order_relaxed);
+        state.ResumeTiming();
+        switch (operation) {
+        case StringOperation::INSERT_COPY:
+            for (const std::string& key : keys) {
+                tree->Insert(key);
+            }
+            break;
+        case StringOperation::INSERT_MOVE:
+            for (std::string& key : movable) {
+                tree->Insert(std::move(key));
+            }
+            break;
+        case StringOperation::EMPLACE:
+            for (const std::string& key : keys) {
+                tree->Emplace(key.c_str());
+            }
+            break;
+        case StringOperation::MAP:
+            mapped = source.map([](std::string value) { return value; });
+            break;
+        case StringOperation::REMOVE:
+            for (const std::string& key : keys) {
+                tree->Remove(key);
+            }
+            break;
+        }
+        benchmark::DoNotOptimize(tree->Size() + mapped.Size());
+        state.PauseTiming();
+        allocations += allocation_count.load(std::memory_order_relaxed) - before;
+        tree.reset();
+        state.ResumeTiming();
+    }
+    state.counters["allocs_per_key"] =
+        static_cast<double>(allocations) / static_cast<double>(state.iterations() * keys.size());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes = TakeSizes(argc, argv);
+    for (size_t n : sizes) {
+        const std::pair<StringOperation, const char*> operations[] = {
+            {StringOperation::INSERT_COPY, "insert_copy"}, {StringOperation::INSERT_MOVE, "insert_move"},
+            {StringOperation::EMPLACE, "emplace"}, {StringOperation::MAP, "map"}, {StringOperation::REMOVE, "remove"}};
+        for (const auto& [operation, operation_name] : operations) {
+            std::string name = std::string("StringAllocs/") + operation_name + "/" + std::to_string(n);
+            benchmark::RegisterBenchmark(name.c_str(), StringAllocs, n, operation);
+        }
+    }
+
+    benchmark::AddCustomContext("balance_policy", "AVL");
+    benchmark::AddCustomContext("input_seed", std::to_string(BENCHMARK_SEED));
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,312 @@
+#ifndef BINARY_TREE_BINARY_FORMAT_H
+#define BINARY_TREE_BINARY_FORMAT_H
+
+#include "exceptions.h"
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+// Компактный двоичный формат дерева (serializeBinary/deserializeBinary)
+//
+// Заголовок: "BTRE" | версия (1 байт) | тег типа ключа (1 байт) | количество узлов (varint)
+// Тело: узлы в прямом порядке (Корень → Лево → Право). Вместо маркеров "null" у каждого узла
+// два бита формы: bit0 - есть левый потомок, bit1 - есть правый.
+//   int                    varint((zigzag(значение - предыдущее) << 2) | форма) - дельта-кодирование
+//   std::string            varint((длина << 2) | форма), затем байты строки
+//   float/double/complex   байт формы, затем IEEE-754 little-endian (complex - две части double)
+// varint - LEB128: по 7 бит на байт, старший бит - "дальше есть байты"
+namespace binary_format {
+
+constexpr char MAGIC[4] = {'B', 'T', 'R', 'E'};
+constexpr uint8_t VERSION = 1;
+
+constexpr uint8_t HAS_LEFT = 1;
+constexpr uint8_t HAS_RIGHT = 2;
+constexpr uint8_t SHAPE_MASK = HAS_LEFT | HAS_RIGHT;
+
+// Наибольшая порция, выделяемая заранее при чтении из потока: длины и счётчики из входных
+// данных не проверить до чтения, поэтому память под них растёт по мере поступления байтов
+constexpr size_t READ_CHUNK = 1 << 16;
+
+// Приёмник байтов, дописывающий в строку
+class StringSink {
+public:
+    explicit StringSink(std::string& output) : out(output) {}
+
+    void Put(uint8_t byte) {
+        out.push_back(static_cast<char>(byte));
+    }
+
+    void Write(const char* data, size_t size) {
+        out.append(data, size);
+    }
+
+private:
+    std::string& out;
+};
+
+// Источник байтов из непрерывного блока памяти
+class MemorySource {
+public:
+    MemorySource(const char* bytes, size_t length) : data(bytes), size(length), position(0) {}
+
+    uint8_t Get() {
+        if (position >= size) {
+            throw SerializationError("unexpected end of binary data");
+        }
+        return static_cast<uint8_t>(data[position++]);
+    }
+
+    void Read(char* destination, size_t count) {
+        if (count > size - position) {
+            throw SerializationError("unexpected end of binary data");
+        }
+        std::memcpy(destination, data + position, count);
+        position += count;
+    }
+
+    bool AtEnd() const {
+        return position == size;
+    }
+
+    // Длина из входных данных не может превышать оставшиеся байты
+    void Require(uint64_t count) const {
+        if (count > size - position) {
+            throw SerializationError("unexpected end of binary data");
+        }
+    }
+
+    // Сколько из count элементов (не меньше байта каждый) можно выделить заранее
+    size_t Bound(uint64_t count) const {
+        return static_cast<size_t>(count < size - position ? count : size - position);
+    }
+
+private:
+    const char* data;
+    size_t size;
+    size_t position;
+};
+
+// Приёмник байтов поверх буфера потока (std::ostream::rdbuf())
+// Байты идут напрямую в буфер потока - дополнительной памяти не требуется
+class StreamSink {
+public:
+    explicit StreamSink(std::streambuf& buffer) : out(buffer) {}
+
+    void Put(uint8_t byte) {
+        if (std::streambuf::traits_type::eq_int_type(out.sputc(static_cast<char>(byte)),
+                                                     std::streambuf::traits_type::eof())) {
+            throw SerializationError("write to stream failed");
+        }
+    }
+
+    void Write(const char* data, size_t size) {
+        if (out.sputn(data, static_cast<std::streamsize>(size)) != static_cast<std::streamsize>(size)) {
+            throw SerializationError("write to stream failed");
+        }
+    }
+
+private:
+    std::streambuf& out;
+};
+
+// Источник байтов поверх буфера потока (std::istream::rdbuf())
+// Читает ровно столько байт, сколько занимает образ дерева: данные после него остаются в потоке
+class StreamSource {
+public:
+    explicit StreamSource(std::streambuf& buffer) : in(buffer) {}
+
+    uint8_t Get() {
+        std::streambuf::int_type byte = in.sbumpc();
+        if (std::streambuf::traits_type::eq_int_type(byte, std::streambuf::traits_type::eof())) {
+            throw SerializationError("unexpected end of binary data");
+        }
+        return static_cast<uint8_t>(byte);
+    }
+
+    void Read(char* destination, size_t count) {
+        if (in.sgetn(destination, static_cast<std::streamsize>(count)) != static_cast<std::streamsize>(count)) {
+            throw SerializationError("unexpected end of binary data");
+        }
+    }
+
+    // Остаток потока неизвестен - длина проверяется по мере чтения
+    void Require(uint64_t) const {}
+
+    size_t Bound(uint64_t count) const {
+        return static_cast<size_t>(count < READ_CHUNK ? count : READ_CHUNK);
+    }
+
+private:
+    std::streambuf& in;
+};
+
+template <typename Sink>
+void WriteVarint(Sink& sink, uint64_t value) {
+    while (value >= 0x80) {
+        sink.Put(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    sink.Put(static_cast<uint8_t>(value));
+}
+
+template <typename Source>
+uint64_t ReadVarint(Source& source) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = source.Get();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw SerializationError("varint is too long");
+}
+
+// Знаковое число -> беззнаковое так, чтобы малые по модулю значения были короткими
+inline uint64_t ZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Побайтовая запись/чтение целого фиксированной ширины в little-endian
+template <typename Sink, typename UInt>
+void WriteFixed(Sink& sink, UInt value) {
+    for (size_t i = 0; i < sizeof(UInt); ++i) {
+        sink.Put(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+template <typename UInt, typename Source>
+UInt ReadFixed(Source& source) {
+    UInt value = 0;
+    for (size_t i = 0; i < sizeof(UInt); ++i) {
+        value |= static_cast<UInt>(source.Get()) << (8 * i);
+    }
+    return value;
+}
+
+// Кодирование значения с битами формы узла
+// State - состояние кодека между узлами (предыдущее значение для дельт)
+template <typename T>
+struct KeyCodec {
+    static_assert(sizeof(T) == 0, "binary format is not defined for this key type");
+};
+
+template <>
+struct KeyCodec<int> {
+    static constexpr uint8_t TAG = 1;
+    struct State {
+        int64_t previous = 0;
+    };
+
+    template <typename Sink>
+    static void Write(Sink& sink, const int& value, uint8_t shape, State& state) {
+        int64_t delta = static_cast<int64_t>(value) - state.previous;
+        state.previous = value;
+        WriteVarint(sink, (ZigZag(delta) << 2) | shape);
+    }
+
+    template <typename Source>
+    static int Read(Source& source, uint8_t& shape, State& state) {
+        uint64_t word = ReadVarint(source);
+        shape = static_cast<uint8_t>(word & SHAPE_MASK);
+        state.previous += UnZigZag(word >> 2);
+        return static_cast<int>(state.previous);
+    }
+};
+
+// Общий кодек для чисел с плавающей точкой: байт формы + биты IEEE-754
+template <typename Float, typename Bits, uint8_t Tag>
+struct FloatCodec {
+    static constexpr uint8_t TAG = Tag;
+    struct State {};
+
+    template <typename Sink>
+    static void Write(Sink& sink, const Float& value, uint8_t shape, State&) {
+        sink.Put(shape);
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        WriteFixed(sink, bits);
+    }
+
+    template <typename Source>
+    static Float Read(Source& source, uint8_t& shape, State&) {
+        shape = source.Get();
+        Bits bits = ReadFixed<Bits>(source);
+        Float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+template <>
+struct KeyCodec<float> : FloatCodec<float, uint32_t, 2> {};
+
+template <>
+struct KeyCodec<double> : FloatCodec<double, uint64_t, 3> {};
+
+template <>
+struct KeyCodec<std::string> {
+    static constexpr uint8_t TAG = 4;
+    struct State {};
+
+    template <typename Sink>
+    static void Write(Sink& sink, const std::string& value, uint8_t shape, State&) {
+        WriteVarint(sink, (static_cast<uint64_t>(value.size()) << 2) | shape);
+        sink.Write(value.data(), value.size());
+    }
+
+    template <typename Source>
+    static std::string Read(Source& source, uint8_t& shape, State&) {
+        uint64_t word = ReadVarint(source);
+        shape = static_cast<uint8_t>(word & SHAPE_MASK);
+        uint64_t length = word >> 2;
+        source.Require(length);
+        // Строка растёт порциями: память выделяется только под действительно прочитанные байты
+        std::string value;
+        while (value.size() < length) {
+            size_t offset = value.size();
+            value.resize(offset + source.Bound(length - offset));
+            source.Read(&value[offset], value.size() - offset);
+        }
+        return value;
+    }
+};
+
+template <>
+struct KeyCodec<std::complex<double>> {
+    static constexpr uint8_t TAG = 5;
+    struct State {};
+
+    template <typename Sink>
+    static void Write(Sink& sink, const std::complex<double>& value, uint8_t shape, State&) {
+        FloatCodec<double, uint64_t, 3>::State parts;
+        FloatCodec<double, uint64_t, 3>::Write(sink, value.real(), shape, parts);
+        double imag = value.imag();
+        uint64_t bits;
+        std::memcpy(&bits, &imag, sizeof(bits));
+        WriteFixed(sink, bits);
+    }
+
+    template <typename Source>
+    static std::complex<double> Read(Source& source, uint8_t& shape, State&) {
+        FloatCodec<double, uint64_t, 3>::State parts;
+        double real = FloatCodec<double, uint64_t, 3>::Read(source, shape, parts);
+        uint64_t bits = ReadFixed<uint64_t>(source);
+        double imag;
+        std::memcpy(&imag, &bits, sizeof(imag));
+        return {real, imag};
+    }
+};
+
+} // namespace binary_format
+
+#endif
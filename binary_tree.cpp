@@ -3,27 +3,14 @@
 #include <algorithm>
 #include <sstream> // Для работы со строками как с потоками(в сериализации)
 #include "exceptions.h" // Исключения
+#include "binary_format.h" // Двоичный формат сериализации
+#include "tree_stream.h" // Потоковые буферы
+#include "mapped_tree.h" // Образ для отображения в память
+#include "counting_allocator.h" // Аллокатор с состоянием (явное инстанцирование)
 #include <complex>
 #include <stack>
 #include <obstack.h>
 
-// Специализация для complex<double>
-namespace std {
-    bool operator<(const complex<double>& a, const complex<double>& b) {
-        if (a.real() != b.real()) {
-            return a.real() < b.real();
-        }
-        return a.imag() < b.imag();
-    }
-    
-    bool operator>(const complex<double>& a, const complex<double>& b) {
-        if (a.real() != b.real()) {
-            return a.real() > b.real();
-        }
-        return a.imag() > b.imag();
-    }
-}
-
 namespace std {
     string to_string(const complex<double>& c) {
         return "(" + to_string(c.real()) + "," + to_string(c.imag()) + ")";
@@ -31,15 +18,28 @@ namespace std {
 }
 
 // Kонструтор по умолчанию
-template <typename T>
-BinaryTree<T>::BinaryTree() : root(nullptr) {} // Корень дерева в nullptr
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>::BinaryTree() : root(nullptr), nodeCount(0), balance(BalancePolicy::NONE), orderStatistics(false) {} // Корень дерева в nullptr
+
+
+// Конструктор с политикой балансировки
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>::BinaryTree(BalancePolicy policy, const Allocator& allocator)
+    : root(nullptr), pool(allocator), nodeCount(0), balance(policy), orderStatistics(false) {}
+
+
+// Конструктор с политикой балансировки и компаратором
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>::BinaryTree(BalancePolicy policy, const Compare& comparator, const Allocator& allocator)
+    : root(nullptr), pool(allocator), nodeCount(0), balance(policy), orderStatistics(false), compare(comparator) {}
 
 
 // Конструктор с параметром 
-template <typename T>
-BinaryTree<T>::BinaryTree(const T& rootValue){ // Принимает константную ссылку на значение корня
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>::BinaryTree(const T& rootValue)
+    : nodeCount(0), balance(BalancePolicy::NONE), orderStatistics(false) { // Принимает константную ссылку на значение корня
     try { // Блок обработки исключений 
-        root = new Node<T>(rootValue); // Выделение памяти для нового узла
+        root = CreateNode(rootValue); // Выделение памяти для нового узла
     }
     // Перехват исключения при нехватки памяти
     catch (const std::bad_alloc&) {
@@ -48,15 +48,17 @@ BinaryTree<T>::BinaryTree(const T& rootValue){ // Принимает конст
 }
 
 // Деструктор
-template <typename T>
-BinaryTree<T>::~BinaryTree(){
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>::~BinaryTree(){
     // Очистка деревa
         Clear();
 }
 
 // Конструктор копирования
-template <typename T>
-BinaryTree<T>::BinaryTree(const BinaryTree& other) { // other - исходное дерево для копирования
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>::BinaryTree(const BinaryTree& other)
+    : pool(other.pool.GetAllocator()), nodeCount(0), balance(other.balance), orderStatistics(other.orderStatistics),
+      compare(other.compare) { // other - исходное дерево для копирования
     try {
         root = other.root ? Copy(other.root) : nullptr; /*тернарный оператор:
                                                         Если other.root существует, вызывает Copy()
@@ -74,15 +76,18 @@ BinaryTree<T>::BinaryTree(const BinaryTree& other) { // other - исходное
 
 // Конструктор перемещения 
 // noexcept - гарантия отсутствия ошибок
-template <typename T>
-BinaryTree<T>::BinaryTree(BinaryTree&& other) noexcept : root(other.root) { // Инициализация корня значением корня другого обьекта
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>::BinaryTree(BinaryTree&& other) noexcept
+    : root(other.root), pool(std::move(other.pool)), nodeCount(other.nodeCount),
+      balance(other.balance), orderStatistics(other.orderStatistics), compare(other.compare) { // Инициализация корня значением корня другого обьекта
     other.root = nullptr; // Обнуление указателя в исходном обьекте
+    other.nodeCount = 0;
 }
 
 // Внутренний (приватный) метод рекурсивной очистки поддерева
 // Полное удаление всех узлов, начиная с заданного узла
-/*template <typename T>
-void BinaryTree<T>::Clear(Node<T>* node) { // указатель на корневой узел поддерева для удаления
+/*template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Clear(Node<T>* node) { // указатель на корневой узел поддерева для удаления
     if (!node) {
         return; // Проверка на nullptr - выход из рекурсии
     }
@@ -118,47 +123,48 @@ void BinaryTree<T>::Clear(Node<T>* node) { // указатель на корне
     
 }*/
 
-template <typename T>
-void BinaryTree<T>::Clear() {
-    if (!root) return;
-    
-    std::stack<Node<T>*> nodeStack;
-    nodeStack.push(root);
-    
-    while (!nodeStack.empty()) {
-        Node<T>* current = nodeStack.top();
-        nodeStack.pop();
-        
-        if (current->left) nodeStack.push(current->left);
-        if (current->right) nodeStack.push(current->right);
-        
-        delete current;
+// Для тривиально разрушаемых T узлы не обходятся: блоки пула освобождаются целиком
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Clear() {
+    if constexpr (NodePool<T, Allocator>::TRIVIAL_RELEASE) {
+        root = nullptr;
+        nodeCount = 0;
+        pool.Release();
+        return;
     }
-    
+
+    Clear(root); // Деструкторы значений, затем освобождение блоков
     root = nullptr;
+    nodeCount = 0;
+    pool.Release();
 }
 
-template <typename T>
-void BinaryTree<T>::Clear(Node<T>* node) {
+// Удаление всех узлов поддерева на явном стеке (глубина дерева не ограничена стеком вызовов)
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Clear(Node<T>* node) {
     if (!node) {
         return;
     }
-    
-    // Рекурсивное удаление потомков
-    Clear(node->left);
-    Clear(node->right);
-    
-    node->left = nullptr;  // Явное обнуление указателей перед удалением
-    node->right = nullptr;
-    // Удаление текущего узла
-    delete node;
+
+    std::vector<Node<T>*> nodeStack{node};
+    while (!nodeStack.empty()) {
+        Node<T>* current = nodeStack.back();
+        nodeStack.pop_back();
+
+        if (current->left) nodeStack.push_back(current->left);
+        if (current->right) nodeStack.push_back(current->right);
+
+        current->left = nullptr;  // Явное обнуление указателей перед удалением
+        current->right = nullptr;
+        DestroyNode(current);
+    }
 }
 
 // Метод полной очистки дерева
 // Удаление всех узлов дерева и сброс корня
 // Гарантирует, что root станет nullptr даже при ошибках
-/*template <typename T>
-void BinaryTree<T>::Clear() {
+/*template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Clear() {
     // Проверка на пустое дерево
     if (!root) {
         return; 
@@ -181,54 +187,53 @@ void BinaryTree<T>::Clear() {
 
 
 // Внутренний (приватный) метод глубокого копирования поддерева
-template <typename T>
-Node<T>* BinaryTree<T>::Copy(Node<T>* node) const {
-    // Базовый случай рекурсии
+// Прямой обход на явном стеке пар (исходный узел, ссылка, куда положить копию)
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::Copy(Node<T>* node) {
+    Node<T>* copyRoot = nullptr;
     if (!node) {
-        return nullptr; 
+        return copyRoot;
     }
 
-    Node<T>* newNode = nullptr; // Сброс newNode на nullptr(гарантированно)
-
+    std::vector<std::pair<Node<T>*, Node<T>**>> nodeStack{{node, &copyRoot}};
     try {
-        newNode = new Node<T>(node->data); // Создание копии узла
+        while (!nodeStack.empty()) {
+            auto [source, link] = nodeStack.back();
+            nodeStack.pop_back();
+
+            Node<T>* newNode = CreateNode(source->data); // Создание копии узла
+            newNode->height = source->height; // Форма копии совпадает с оригиналом
+            newNode->subtreeSize = source->subtreeSize;
+            *link = newNode;
+
+            if (source->right) nodeStack.push_back({source->right, &newNode->right});
+            if (source->left) nodeStack.push_back({source->left, &newNode->left});
+        }
     }
     catch (const std::bad_alloc&) { // Если памяти нет
+        Clear(copyRoot); // Очистка частично скопированных данных
         throw TreeException("Memory allocation failed for node copy");
     }
-
-    // Рекурсивное копирование левого поддерева
-    try {
-        newNode->left = Copy(node->left);
-    }
     catch (...) {
-        delete newNode; // Очистка частично скопированных данных
-        throw TreeException("Failed to copy left subtree");
+        Clear(copyRoot);
+        throw TreeException("Failed to copy subtree");
     }
 
-    // Рекурсивное копирование правого поддерева
-    try {
-        newNode->right = Copy(node->right);  // Рекурсивное копирование правого поддерева
-    }
-    catch (...) {
-        delete newNode->left;  // Очистка
-        delete newNode;
-        throw TreeException("Failed to copy right subtree");
-    }
-
-    return newNode;  // Возврат готовой копии
-
+    return copyRoot;  // Возврат готовой копии
 }
 
 
 // Оператор присваивания копированием
 // Очищает текущее дерево и создает копию другого
-template <typename T>
-BinaryTree<T>& BinaryTree<T>::operator=(const BinaryTree& other) { // other - исходное дерево для копирования
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>& BinaryTree<T, Compare, Allocator>::operator=(const BinaryTree& other) { // other - исходное дерево для копирования
     // Проверка на самоприсваивание
     if (this != &other) {
         try {
             Clear(); // Очистка текущего дерева
+            balance = other.balance;
+            orderStatistics = other.orderStatistics;
+            compare = other.compare;
             root = other.root ? Copy(other.root) : nullptr; // Копирование
         }
         catch (const std::bad_alloc&) {
@@ -246,13 +251,19 @@ BinaryTree<T>& BinaryTree<T>::operator=(const BinaryTree& other) { // other - и
 
 // Оператор присваивания перемещением
 // Освобождает текущие ресурсы и захватывает чужие
-template <typename T>
-BinaryTree<T>& BinaryTree<T>::operator=(BinaryTree&& other) noexcept { // other - временный обьект
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator>& BinaryTree<T, Compare, Allocator>::operator=(BinaryTree&& other) noexcept { // other - временный обьект
     // Провекрка на самоприсваивание
     if (this != &other) {
         Clear(); // Очистка текущих данных
         root = other.root; // Захват указателя
+        pool = std::move(other.pool); // Узлы живут в блоках пула - забираем их вместе с корнем
+        nodeCount = other.nodeCount;
+        balance = other.balance;
+        orderStatistics = other.orderStatistics;
+        compare = other.compare;
         other.root = nullptr; // Обнуление исходного указателя
+        other.nodeCount = 0;
     }
 
     return *this; // Возврат текущего объекта
@@ -260,29 +271,104 @@ BinaryTree<T>& BinaryTree<T>::operator=(BinaryTree&& other) noexcept { // other
 
 
 
-// Рекурсивный поиск узла с указанным значением в поддереве
-template <typename T>
-Node<T>* BinaryTree<T>::FindNode(Node<T>* node, const T& value) const {
-     // Базовый случай: узел не найден
-    if (!node) {
-        return nullptr;
+// Итеративный поиск узла с указанным значением в поддереве
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::FindNode(Node<T>* node, const T& value) const {
+    return FindNode(node, value, [] {});
+}
+
+// Чередующиеся спуски: BATCH_LANES "дорожек", у каждой свой ключ и текущий узел
+// За один проход по дорожкам каждая делает один шаг вниз и запрашивает предвыборку следующего узла,
+// так что к её следующему шагу узел, скорее всего, уже в кэше. Закончившая дорожка сразу берёт новый ключ
+template <typename T, typename Compare, typename Allocator>
+template <typename Store>
+void BinaryTree<T, Compare, Allocator>::DescendBatch(const T* keys, size_t count, bool sortForLocality, Store store) const {
+    std::vector<size_t> order;
+    if (sortForLocality) {
+        order.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this, keys](size_t a, size_t b) { return compare(keys[a], keys[b]); });
     }
-    // Значение найдено
-    if (value == node->data) {
-        return node;
+    auto keyIndex = [&order, sortForLocality](size_t position) { return sortForLocality ? order[position] : position; };
+
+    if (!root) {
+        for (size_t i = 0; i < count; ++i) {
+            store(i, nullptr);
+        }
+        return;
     }
-    // сравнение для определения направления поиска
-    if (value < node->data) {
-        return FindNode(node->left, value); // Поиск в левом поддеревe
+
+    Node<T>* cursor[BATCH_LANES];
+    size_t index[BATCH_LANES];
+    const size_t lanes = std::min(BATCH_LANES, count);
+    size_t next = 0;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        index[lane] = keyIndex(next++);
+        cursor[lane] = root;
     }
-    else {
-        return FindNode(node->right, value); // Поиск в правом поддеревe
+
+    size_t active = lanes;
+    while (active > 0) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            Node<T>* node = cursor[lane];
+            if (!node) {
+                continue; // Дорожка закончила, новых ключей нет
+            }
+            const T& key = keys[index[lane]];
+            Node<T>* found = nullptr;
+            bool finished = false;
+            const int direction = KeyOrder(compare, key, node->data);
+            if (direction < 0) {
+                node = node->left;
+                finished = !node;
+            }
+            else if (direction > 0) {
+                node = node->right;
+                finished = !node;
+            }
+            else {
+                found = node;
+                finished = true;
+            }
+
+            if (finished) {
+                store(index[lane], found);
+                if (next < count) {
+                    index[lane] = keyIndex(next++);
+                    node = root;
+                } else {
+                    node = nullptr;
+                    --active;
+                }
+            }
+#if defined(__GNUC__) || defined(__clang__)
+            if (node) {
+                __builtin_prefetch(node);
+            }
+#endif
+            cursor[lane] = node;
+        }
     }
 }
 
+// Пакетная проверка существования
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::ContainsBatch(const T* keys, size_t count, bool* results, bool sortForLocality) const {
+    DescendBatch(keys, count, sortForLocality, [results](size_t i, Node<T>* node) { results[i] = node != nullptr; });
+}
+
+// Пакетный поиск указателей на значения
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::FindBatch(const T* keys, size_t count, const T** results, bool sortForLocality) const {
+    DescendBatch(keys, count, sortForLocality,
+                 [results](size_t i, Node<T>* node) { results[i] = node ? &node->data : nullptr; });
+}
+
 // Поиск узла с минимальным значением в поддереве
-template <typename T>
-Node<T>* BinaryTree<T>::FindMin(Node<T>* node) const {
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::FindMin(Node<T>* node) const {
     // Пустое поддерево
     if (!node) {
         return nullptr;
@@ -294,155 +380,569 @@ Node<T>* BinaryTree<T>::FindMin(Node<T>* node) const {
     return node; // Возврат узла без левых потомков
 }
 
-// Рекурсивное удаление узла с указанным значением
-template <typename T>
-Node<T>* BinaryTree<T>::RemoveNode(Node<T>* node, const T& value) {
-    // Узел не найден
-    if (!node) {
-        return nullptr;
+// Вставка значения - добавление нового узла с указанным значением в дерево
+// Повторная вставка существующего значения ничего не меняет
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Insert(const T& value) {
+    InsertValue(value);
+}
+
+// Вставка с перемещением значения в новый узел
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Insert(T&& value) {
+    InsertValue(std::move(value));
+}
+
+// Спуск к месту вставки; value (const T& или T&&) передаётся дальше только в CreateNode
+template <typename T, typename Compare, typename Allocator>
+template <typename Value>
+void BinaryTree<T, Compare, Allocator>::InsertValue(Value&& value) {
+    BINARY_TREE_STATS_ONLY(OperationScope scope(stats.insert);)
+    const bool track = TracksPath();
+    path.clear();
+
+    Node<T>** link = &root;
+    while (*link) {
+        BINARY_TREE_STATS_ONLY(scope.Visit();)
+        const int order = KeyOrder(compare, value, (*link)->data);
+        if (order < 0) { // В левое поддерево
+            if (track) path.push_back(link);
+            link = &(*link)->left;
+        }
+        else if (order > 0) { // В правое поддерево
+            if (track) path.push_back(link);
+            link = &(*link)->right;
+        }
+        else {
+            return; // Значение уже есть в дереве
+        }
     }
-    // Рекурсивный поиск узла
+
     try {
-        // сравнение для определения направления поиска
-        if (value < node->data) {
-            node->left = RemoveNode(node->left, value); // Поиск в левом поддереве
-        }
-        else if (value > node->data) {
-            node->right = RemoveNode(node->right, value); // Поиск в правом поддереве
-        }
-        else { // Найден узел для удаления
-            if (!node->left) { // Нет левого поддерева
-                Node<T>* temp = node->right;
-                node->right = nullptr; // Обнуление перед удалением
-                delete node;
-                return temp;
-            }
-            else if (!node->right) {    // Нет правого поддерева
-                Node<T>* temp = node->left;
-                node->left = nullptr;   // Обнуление перед удалением
-                delete node;
-                return temp;
-            }
-            // Есть оба поддерева
-            Node<T>* temp = FindMin(node->right); // Поиск минимума справа
-            node->data = temp->data; // Копирование данных
-            node->right = RemoveNode(node->right, value); // Удаление дубликата
-        }
+        *link = CreateNode(std::forward<Value>(value)); // Вставка на место найденной пустой ссылки
+    }
+    catch (const std::bad_alloc&) {
+        throw TreeException(link == &root ? "Memory allocation failed for root node"
+                                          : "Memory allocation failed for tree node");
+    }
+
+    FixPath();
+    BINARY_TREE_STATS_ONLY(scope.Hit();)
+}
+
+
+// Метод проверки существования значения
+template <typename T, typename Compare, typename Allocator>
+bool BinaryTree<T, Compare, Allocator>::Contains(const T& value) const {
+    return ContainsKey(value);
+}
+
+// Проверка существования значения без исключений
+// Тот же итеративный спуск, что и в Contains, но промах - это просто false
+template <typename T, typename Compare, typename Allocator>
+bool BinaryTree<T, Compare, Allocator>::TryContains(const T& value) const noexcept {
+    return LookupNode(value) != nullptr;
+}
+
+// Поиск значения без исключений: указатель на хранимое значение или nullptr
+template <typename T, typename Compare, typename Allocator>
+const T* BinaryTree<T, Compare, Allocator>::Find(const T& value) const noexcept {
+    Node<T>* node = LookupNode(value);
+    return node ? &node->data : nullptr;
+}
+
+// Удаление значения (с сохранением структуры дерева)
+// Существование проверяется тем же спуском, что и удаление (без отдельного Contains)
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Remove(const T& value) {
+    bool removed = false;
+    try {
+        removed = RemoveNode(value); // Вызов внутренней функции (основной алгоритм удаления)
     }
     catch (...) {
         throw TreeException("Failed to remove node");
     }
 
-    return node; // Возврат текущего узла
+    // Проверка существования
+    if (!removed) {
+        throw TreeException("Cannot remove - value not found in tree");
+    }
 }
 
-// Вставка значения - добавление нового узла с указанным значением в дерево
-template <typename T>
-void BinaryTree<T>::Insert(const T& value) {
-    // Случай пустого дерева
-    if (!root) {
-        try {
-            root = new Node<T>(value); // Попытка создания корня
-        }
-        catch (const std::bad_alloc&) {
-            throw TreeException("Memory allocation failed for root node");
+// Проверка пустоты
+template <typename T, typename Compare, typename Allocator>
+bool BinaryTree<T, Compare, Allocator>::IsEmpty() const{
+    return root == nullptr; // Если нет корня - значит дерево пустое
+}
+
+// Текущая политика балансировки
+template <typename T, typename Compare, typename Allocator>
+BalancePolicy BinaryTree<T, Compare, Allocator>::GetBalancePolicy() const {
+    return balance;
+}
+
+// Включение порядковых статистик
+// Размеры поддеревьев считаются один раз за O(n), дальше поддерживаются при вставке/удалении
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::EnableOrderStatistics() {
+    if (!orderStatistics) {
+        orderStatistics = true;
+        RefreshMetadata(root);
+    }
+}
+
+// Включены ли порядковые статистики
+template <typename T, typename Compare, typename Allocator>
+bool BinaryTree<T, Compare, Allocator>::HasOrderStatistics() const {
+    return orderStatistics;
+}
+
+// Количество значений, строго меньших value
+template <typename T, typename Compare, typename Allocator>
+size_t BinaryTree<T, Compare, Allocator>::Rank(const T& value) const {
+    return RankOf(value);
+}
+
+// k-е по возрастанию значение (нумерация с 0)
+template <typename T, typename Compare, typename Allocator>
+T BinaryTree<T, Compare, Allocator>::Select(size_t k) const {
+    if (k >= nodeCount) {
+        throw NodeNotFound("Select index " + std::to_string(k) + " is out of range");
+    }
+
+    if (!orderStatistics) {
+        // Без размеров поддеревьев - симметричный обход до k-го элемента
+        Node<T>* current = root;
+        std::stack<Node<T>*> nodeStack;
+        while (current || !nodeStack.empty()) {
+            while (current) {
+                nodeStack.push(current);
+                current = current->left;
+            }
+            current = nodeStack.top();
+            nodeStack.pop();
+            if (k-- == 0) {
+                return current->data;
+            }
+            current = current->right;
         }
-        return;
     }
 
     Node<T>* current = root;
-    while (1) {
-        if (value < current->data) { // В левое поддерево
-            if (!current->left) {
-                try {
-                    current->left = new Node<T>(value); // Вставка слева
-                    break;
-                }
-                catch (const std::bad_alloc&) {
-                    throw TreeException("Memory allocation failed for left node");
-                }
-            }
+    while (current) {
+        size_t leftSize = NodeSize(current->left);
+        if (k < leftSize) {
             current = current->left;
         }
-        else if (value > current->data) { // В правое поддерево
-            if (!current->right) {
-                try {
-                    current->right = new Node<T>(value); // Вставка справа
-                    break;
-                }
-                catch (const std::bad_alloc&) {
-                    throw TreeException("Memory allocation failed for right node");
-                }
-            }
+        else if (k == leftSize) {
+            return current->data;
+        }
+        else {
+            k -= leftSize + 1;
             current = current->right;
         }
-        
     }
+    throw NodeNotFound("Select index is out of range"); // Недостижимо при согласованных размерах
 }
 
+// Копия аллокатора дерева
+template <typename T, typename Compare, typename Allocator>
+Allocator BinaryTree<T, Compare, Allocator>::GetAllocator() const {
+    return pool.GetAllocator();
+}
 
-// Метод проверки существования значения
-template <typename T>
-bool BinaryTree<T>::Contains(const T& value) const {
-    // Проверка на пустоту
-    if (IsEmpty()) {
-        throw TreeException("Tree is empty - cannot check containment");
-    }
+// Копия компаратора дерева
+template <typename T, typename Compare, typename Allocator>
+Compare BinaryTree<T, Compare, Allocator>::GetCompare() const {
+    return compare;
+}
 
-    // Старт с корня
-    Node<T>* current = root;
-    
-    while (current != nullptr) { // Пока есть узлы для проверки
-        if (value == current->data) { // Значение найдено
-            return true;
+// Высота дерева
+// Для AVL хранится в корне, иначе считается обходом по уровням (без рекурсии)
+template <typename T, typename Compare, typename Allocator>
+size_t BinaryTree<T, Compare, Allocator>::Height() const {
+    if (!root) {
+        return 0;
+    }
+    if (balance == BalancePolicy::AVL) {
+        return static_cast<size_t>(root->height);
+    }
+
+    size_t height = 0;
+    std::queue<Node<T>*> level;
+    level.push(root);
+    while (!level.empty()) {
+        ++height;
+        for (size_t i = level.size(); i > 0; --i) { // Обработка одного уровня
+            Node<T>* current = level.front();
+            level.pop();
+            if (current->left) level.push(current->left);
+            if (current->right) level.push(current->right);
         }
-        else if (value < current->data) { // Движение влево
-            if (!current->left) {
-                throw TreeException("Value not found - left subtree ended");
+    }
+    return height;
+}
+
+
+
+// Снимок статистики: размер и высота доступны всегда, счётчики - при сборке с BINARY_TREE_STATS
+template <typename T, typename Compare, typename Allocator>
+TreeStats BinaryTree<T, Compare, Allocator>::Stats() const {
+    TreeStats result;
+    result.size = nodeCount;
+    result.height = Height();
+    result.poolChunks = pool.ChunkCount();
+#ifdef BINARY_TREE_STATS
+    result.enabled = true;
+    result.nodesAllocated = stats.nodesAllocated.load(std::memory_order_relaxed);
+    result.nodesFreed = stats.nodesFreed.load(std::memory_order_relaxed);
+    result.insert = stats.insert.Snapshot();
+    result.contains = stats.contains.Snapshot();
+    result.remove = stats.remove.Snapshot();
+#endif
+    return result;
+}
+
+// Обнуление счётчиков
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::ResetStats() {
+    BINARY_TREE_STATS_ONLY(stats.Reset();)
+}
+
+
+
+// Форма дерева: обратный обход на явном стеке, высоты поддеревьев передаются от детей родителю
+// Высоты считаются заново (в несбалансированном дереве поля узлов не поддерживаются)
+template <typename T, typename Compare, typename Allocator>
+TreeShape BinaryTree<T, Compare, Allocator>::Analyze() const {
+    TreeShape shape;
+    shape.size = nodeCount;
+    shape.optimalHeight = TreeShape::OptimalHeight(nodeCount);
+    if (!root) {
+        return shape;
+    }
+
+    struct Frame {
+        Node<T>* node;
+        size_t depth;
+        size_t leftHeight;
+        int stage; // 0 - узел не обработан, 1 - обойдено левое поддерево, 2 - правое
+    };
+    std::vector<Frame> stack;
+    stack.push_back({root, 1, 0, 0});
+    size_t returned = 0; // Высота только что завершённого поддерева
+    size_t depthSum = 0;
+    size_t leafDepthSum = 0;
+    size_t missDepthSum = 0;
+    shape.minLeafDepth = SIZE_MAX;
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        Node<T>* node = frame.node;
+        if (frame.stage == 0) {
+            const size_t depth = frame.depth;
+            if (shape.depthHistogram.size() < depth) {
+                shape.depthHistogram.resize(depth);
             }
-            current = current->left;
+            ++shape.depthHistogram[depth - 1];
+            depthSum += depth;
+            const int children = (node->left ? 1 : 0) + (node->right ? 1 : 0);
+            missDepthSum += static_cast<size_t>(2 - children) * depth; // Пустые ссылки узла
+            if (children == 0) {
+                ++shape.leaves;
+                leafDepthSum += depth;
+                shape.minLeafDepth = std::min(shape.minLeafDepth, depth);
+                shape.maxLeafDepth = std::max(shape.maxLeafDepth, depth);
+            }
+            else if (children == 1) {
+                ++shape.oneChildNodes;
+            }
+            else {
+                ++shape.twoChildNodes;
+            }
+            frame.stage = 1;
+            if (node->left) {
+                stack.push_back({node->left, depth + 1, 0, 0});
+                continue;
+            }
+            returned = 0;
         }
-        else { // Движение вправо
-            if (!current->right) { 
-                throw TreeException("Value not found - right subtree ended");
+        if (frame.stage == 1) {
+            frame.leftHeight = returned;
+            frame.stage = 2;
+            if (node->right) {
+                stack.push_back({node->right, frame.depth + 1, 0, 0});
+                continue;
             }
-            current = current->right;
+            returned = 0;
+        }
+        // Оба поддерева обойдены: returned - высота правого
+        const long long factor = static_cast<long long>(frame.leftHeight) - static_cast<long long>(returned);
+        const long long limit = static_cast<long long>(TreeShape::BALANCE_LIMIT);
+        ++shape.balanceHistogram[static_cast<size_t>(std::max(-limit, std::min(limit, factor)) + limit)];
+        if (factor > 1 || factor < -1) {
+            ++shape.avlViolations;
+        }
+        returned = 1 + std::max(frame.leftHeight, returned);
+        stack.pop_back();
+    }
+
+    shape.height = returned;
+    shape.averageLeafDepth = static_cast<double>(leafDepthSum) / shape.leaves;
+    shape.averageHitDepth = static_cast<double>(depthSum) / nodeCount;
+    shape.averageMissDepth = static_cast<double>(missDepthSum) / (nodeCount + 1);
+    // Каждый узел пути - отдельный промах кэша: узлы разбросаны по блокам пула
+    const size_t linesPerNode = (sizeof(Node<T>) + 63) / 64;
+    shape.cacheLinesPerLookup = shape.averageHitDepth * static_cast<double>(linesPerNode);
+    return shape;
+}
+
+// Балансировка Дэя-Стаута-Уоррена
+// 1) Правыми поворотами дерево вытягивается в "лозу" - цепочку по правым ссылкам (упорядоченную)
+// 2) Серии левых поворотов через узел сворачивают лозу: сначала "лишние" узлы нижнего неполного
+//    уровня, затем каждая серия вдвое укорачивает правую цепочку.
+// Каждый узел поворачивается O(1) раз, указатели меняются на месте - O(n) времени, O(1) памяти
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Rebalance() {
+    // Дерево -> лоза
+    size_t count = 0;
+    Node<T>** link = &root;
+    while (*link) {
+        Node<T>* node = *link;
+        if (node->left) { // Правый поворот: левый потомок поднимается на место узла
+            Node<T>* left = node->left;
+            node->left = left->right;
+            left->right = node;
+            *link = left;
+        }
+        else {
+            ++count;
+            link = &node->right;
         }
     }
-    
-    return false; // Не найдено
+
+    // Серия из rotations левых поворотов через узел, начиная с корня лозы
+    auto compress = [this](size_t rotations) {
+        Node<T>** current = &root;
+        for (size_t i = 0; i < rotations; ++i) {
+            Node<T>* node = *current;
+            Node<T>* right = node->right;
+            node->right = right->left;
+            right->left = node;
+            *current = right;
+            current = &right->right;
+        }
+    };
+    // full - узлов в полных уровнях (2^k - 1 <= count), остальные уходят на нижний уровень
+    size_t full = 1;
+    while (full <= (count + 1) / 2) {
+        full *= 2;
+    }
+    full -= 1;
+    compress(count - full);
+    for (size_t rotations = full / 2; rotations > 0; rotations /= 2) {
+        compress(rotations);
+    }
+
+    // Высоты и размеры поддеревьев (стек - O(log n) после балансировки)
+    if (TracksPath()) {
+        RefreshMetadata(root);
+    }
 }
 
 
 
-// Удаление значения (с сохранением структуры дерева)
-template <typename T>
-void BinaryTree<T>::Remove(const T& value) {
-    // Проверка существования
-    if (!Contains(value)) {
-        throw TreeException("Cannot remove - value not found in tree");
+// Нужно ли запоминать путь при вставке/удалении
+// Для несбалансированного дерева без порядковых статистик путь не нужен (экономия памяти на вырожденных деревьях)
+template <typename T, typename Compare, typename Allocator>
+bool BinaryTree<T, Compare, Allocator>::TracksPath() const {
+    return balance != BalancePolicy::NONE || orderStatistics;
+}
+
+// Высота поддерева (nullptr = 0)
+template <typename T, typename Compare, typename Allocator>
+int BinaryTree<T, Compare, Allocator>::NodeHeight(Node<T>* node) {
+    return node ? node->height : 0;
+}
+
+// Размер поддерева (nullptr = 0)
+template <typename T, typename Compare, typename Allocator>
+size_t BinaryTree<T, Compare, Allocator>::NodeSize(Node<T>* node) {
+    return node ? node->subtreeSize : 0;
+}
+
+// Пересчёт высоты и размера поддерева узла по его потомкам
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::UpdateNode(Node<T>* node) {
+    node->height = 1 + std::max(NodeHeight(node->left), NodeHeight(node->right));
+    node->subtreeSize = 1 + NodeSize(node->left) + NodeSize(node->right);
+}
+
+// Создание узла в пуле с учётом счётчика узлов
+template <typename T, typename Compare, typename Allocator>
+template <typename Value>
+Node<T>* BinaryTree<T, Compare, Allocator>::CreateNode(Value&& value) {
+    Node<T>* node = pool.Create(std::forward<Value>(value));
+    ++nodeCount;
+    BINARY_TREE_STATS_ONLY(stats.nodesAllocated.fetch_add(1, std::memory_order_relaxed);)
+    return node;
+}
+
+// Уничтожение узла с учётом счётчика узлов
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::DestroyNode(Node<T>* node) {
+    if (node) {
+        pool.Destroy(node);
+        --nodeCount;
+        BINARY_TREE_STATS_ONLY(stats.nodesFreed.fetch_add(1, std::memory_order_relaxed);)
     }
+}
 
-    try {
-        root =  RemoveNode(root, value); // Вызов внутренней функции (основной алгоритм удаления)
+// Малый левый поворот: правый потомок становится корнем поддерева
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::RotateLeft(Node<T>* node) {
+    Node<T>* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    UpdateNode(node); // Сначала опустившийся узел, затем новый корень
+    UpdateNode(pivot);
+    return pivot;
+}
+
+// Малый правый поворот (зеркально RotateLeft)
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::RotateRight(Node<T>* node) {
+    Node<T>* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    UpdateNode(node);
+    UpdateNode(pivot);
+    return pivot;
+}
+
+// Восстановление AVL-инварианта в узле
+// Разница высот больше 1 устраняется одним или двумя (большой поворот) поворотами
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::RebalanceNode(Node<T>* node) {
+    int factor = NodeHeight(node->left) - NodeHeight(node->right);
+    if (factor > 1) { // Перевес слева
+        if (NodeHeight(node->left->left) < NodeHeight(node->left->right)) {
+            node->left = RotateLeft(node->left); // Случай лево-право
+        }
+        return RotateRight(node);
     }
-    catch (...) {
-        throw TreeException("Failed to remove node");
+    if (factor < -1) { // Перевес справа
+        if (NodeHeight(node->right->right) < NodeHeight(node->right->left)) {
+            node->right = RotateRight(node->right); // Случай право-лево
+        }
+        return RotateLeft(node);
     }
+    return node;
 }
 
-// Проверка пустоты
-template <typename T>
-bool BinaryTree<T>::IsEmpty() const{
-    return root == nullptr; // Если нет корня - значит дерево пустое
+// Обновление всех узлов сохранённого пути снизу вверх
+// Поворот меняет только ссылку *link, ссылки выше по пути остаются валидными
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::FixPath() {
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        Node<T>** link = *it;
+        UpdateNode(*link);
+        if (balance == BalancePolicy::AVL) {
+            *link = RebalanceNode(*link);
+        }
+    }
+    path.clear();
+}
+
+// Пересчёт высот и размеров всех узлов поддерева
+// Обратный обход на явном стеке: потомки обрабатываются раньше родителя
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::RefreshMetadata(Node<T>* node) {
+    if (!node) {
+        return;
+    }
+    std::stack<std::pair<Node<T>*, bool>> nodeStack; // (узел, потомки уже обработаны)
+    nodeStack.push({node, false});
+    while (!nodeStack.empty()) {
+        auto [current, childrenDone] = nodeStack.top();
+        nodeStack.pop();
+        if (childrenDone) {
+            UpdateNode(current);
+            continue;
+        }
+        nodeStack.push({current, true});
+        if (current->left) nodeStack.push({current->left, false});
+        if (current->right) nodeStack.push({current->right, false});
+    }
+}
+
+
+
+// Количество значений в [lo, hi): O(log n) для AVL с порядковыми статистиками
+template <typename T, typename Compare, typename Allocator>
+size_t BinaryTree<T, Compare, Allocator>::CountRange(const T& lo, const T& hi) const {
+    return CountRangeOf(lo, hi);
+}
+
+// Удаление всех значений из [lo, hi)
+// Сначала собираются указатели на значения (итерирование по дереву во время удаления недопустимо)
+// RemoveNode переносит узлы, а не значения, поэтому указатели на ещё не удалённые значения действительны
+template <typename T, typename Compare, typename Allocator>
+size_t BinaryTree<T, Compare, Allocator>::RemoveRange(const T& lo, const T& hi) {
+    std::vector<const T*> doomed;
+    ForEachInRange(lo, hi, [&doomed](const T& value) { doomed.push_back(&value); });
+    for (const T* value : doomed) {
+        RemoveNode(*value);
+    }
+    return doomed.size();
+}
+
+// Итератор на наименьшее значение
+template <typename T, typename Compare, typename Allocator>
+typename BinaryTree<T, Compare, Allocator>::const_iterator BinaryTree<T, Compare, Allocator>::begin() const {
+    const_iterator it(root);
+    if (root) {
+        it.path.push_back(root);
+        it.DescendLeft();
+    }
+    return it;
+}
+
+// Итератор за последним значением
+template <typename T, typename Compare, typename Allocator>
+typename BinaryTree<T, Compare, Allocator>::const_iterator BinaryTree<T, Compare, Allocator>::end() const {
+    return const_iterator(root);
+}
+
+// Первое значение >= value
+template <typename T, typename Compare, typename Allocator>
+typename BinaryTree<T, Compare, Allocator>::const_iterator BinaryTree<T, Compare, Allocator>::lower_bound(const T& value) const {
+    return Bound(value, false);
+}
+
+// Первое значение > value
+template <typename T, typename Compare, typename Allocator>
+typename BinaryTree<T, Compare, Allocator>::const_iterator BinaryTree<T, Compare, Allocator>::upper_bound(const T& value) const {
+    return Bound(value, true);
+}
+
+// Диапазон значений, равных value
+template <typename T, typename Compare, typename Allocator>
+std::pair<typename BinaryTree<T, Compare, Allocator>::const_iterator, typename BinaryTree<T, Compare, Allocator>::const_iterator>
+BinaryTree<T, Compare, Allocator>::equal_range(const T& value) const {
+    const_iterator first = lower_bound(value);
+    const_iterator last = first;
+    if (last != end() && !compare(value, *last)) {
+        ++last; // Значения уникальны - равный элемент не больше одного
+    }
+    return {first, last};
 }
 
 
 
 // Приватный метод обхода поддерева
 // Параметры: корень поддерева для обхода, тип обхода, функция обработки элементов
-template <typename T>
-void BinaryTree<T>::Traverse(Node<T>* node, TraversalType type, std::function<void(T)> action) const {
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Traverse(Node<T>* node, TraversalType type, std::function<void(T)> action) const {
     // Пустое поддерево - выход
     if (!node) {
         return;
@@ -483,8 +983,8 @@ void BinaryTree<T>::Traverse(Node<T>* node, TraversalType type, std::function<vo
 
 // Публичный метод обхода дерева
 // Параметры: тип обхода, функция, применяемая к каждому узлу
-template <typename T>
-void BinaryTree<T>::Traverse(TraversalType type, std::function<void(T)> action) const {
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::Traverse(TraversalType type, std::function<void(T)> action) const {
     Node<T>* node = root;
     // Bалидация переданной функции
     if (!action) {
@@ -520,233 +1020,422 @@ void BinaryTree<T>::Traverse(TraversalType type, std::function<void(T)> action)
     }
 }
 
-// Прямой обход (Корень → Лево → Право) 
-// Параметры: текущий узел, функция обработки
-template <typename T>
-void BinaryTree<T>::PreOrder(Node<T>* node, std::function<void(T)> action) const {
-    // Базовый случай рекурсии (выход)
-    if (!node) {
-        return;
-    }
-
-    try {
-        action(node->data); // Обработка текущего узла
-    }
-    catch (...) {
-        throw TreeException("Action failed during PreOrder traversal");
-    }
-
-    PreOrder(node->left, action); // Левое поддерево
-    PreOrder(node->right, action); // Правое поддерево
+// Прямой обход (Корень → Лево → Право)
+// Параметры: корень поддерева, функция обработки
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::PreOrder(Node<T>* node, std::function<void(T)> action) const {
+    auto visit = [&action](const T& value) {
+        try {
+            action(value); // Обработка текущего узла
+        }
+        catch (...) {
+            throw TreeException("Action failed during PreOrder traversal");
+        }
+    };
+    VisitSubtree<TraversalType::PRE_ORDER>(node, visit);
 }
 
 // Обратный прямой обход (Корень → Право → Лево)
-// Параметры: текущий узел, функция обработки
-template <typename T>
-void BinaryTree<T>::ReversePreOrder(Node<T>* node, std::function<void(T)> action) const {
-    // Базовый случай рекурсии (выход)
-    if (!node) {
-        return;
-    }
-
-    try {
-        action(node->data); // Обработка текущего узла
-    }
-    catch (...) {
-        throw TreeException("Action failed during ReversePreOrder traversal");
-    }
-    
-    ReversePreOrder(node->right, action); // Правое поддерево
-    ReversePreOrder(node->left, action);  // Левое поддерево
+// Параметры: корень поддерева, функция обработки
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::ReversePreOrder(Node<T>* node, std::function<void(T)> action) const {
+    auto visit = [&action](const T& value) {
+        try {
+            action(value); // Обработка текущего узла
+        }
+        catch (...) {
+            throw TreeException("Action failed during ReversePreOrder traversal");
+        }
+    };
+    VisitSubtree<TraversalType::REVERSE_PRE_ORDER>(node, visit);
 }
 
 // Симметричный обход (Лево → Корень → Право)
 // Для BST(Binary Search Tree) возвращает отсортированную последовательность
-// Параметры: текущий узел, функция обработки
-template <typename T>
-void BinaryTree<T>::InOrder(Node<T>* node, std::function<void(T)> action) const {
-    // Базовый случай рекурсии (выход)
-    if (!node) {
-        return;
-    } 
-    
-    InOrder(node->left, action); // Левое поддерево
-    
-    try {
-        action(node->data); // Текущий узел
-    }
-    catch (...) {
-        throw TreeException("Action failed during InOrder traversal");
-    }
-    
-    InOrder(node->right, action); // Правое поддерево
+// Параметры: корень поддерева, функция обработки
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::InOrder(Node<T>* node, std::function<void(T)> action) const {
+    auto visit = [&action](const T& value) {
+        try {
+            action(value); // Обработка текущего узла
+        }
+        catch (...) {
+            throw TreeException("Action failed during InOrder traversal");
+        }
+    };
+    VisitSubtree<TraversalType::IN_ORDER>(node, visit);
 }
 
 // Обратный симметричный обход (Право → Корень → Лево)
 // Для BST возвращает элементы в обратном порядке
-// Параметры: текущий узел, функция обработки
-template <typename T>
-void BinaryTree<T>::ReverseInOrder(Node<T>* node, std::function<void(T)> action) const {
-    // Базовый случай рекурсии (выход)
-    if (!node) {
-        return;
-    }
-    ReverseInOrder(node->right, action); // Правое поддерево
-    
-    try {
-        action(node->data); // Текущий узел
-    }
-    catch (...) {
-        throw TreeException("Action failed during ReverseInOrder traversal");
-    }
-    
-    ReverseInOrder(node->left, action); // Левое поддерево
+// Параметры: корень поддерева, функция обработки
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::ReverseInOrder(Node<T>* node, std::function<void(T)> action) const {
+    auto visit = [&action](const T& value) {
+        try {
+            action(value); // Обработка текущего узла
+        }
+        catch (...) {
+            throw TreeException("Action failed during ReverseInOrder traversal");
+        }
+    };
+    VisitSubtree<TraversalType::REVERSE_IN_ORDER>(node, visit);
 }
 
 // Обратный обход (Лево → Право → Корень)
-// Параметры: текущий узел, функция обработки
-template <typename T>
-void BinaryTree<T>::PostOrder(Node<T>* node, std::function<void(T)> action) const {
-    // Базовый случай рекурсии (выход)
-    if (!node) {
-        return;
+// Параметры: корень поддерева, функция обработки
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::PostOrder(Node<T>* node, std::function<void(T)> action) const {
+    auto visit = [&action](const T& value) {
+        try {
+            action(value); // Обработка текущего узла
+        }
+        catch (...) {
+            throw TreeException("Action failed during PostOrder traversal");
+        }
+    };
+    VisitSubtree<TraversalType::POST_ORDER>(node, visit);
+}
+
+// Обратный обратный обход (Право → Лево → Корень)
+// Параметры: корень поддерева, функция обработки
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::ReversePostOrder(Node<T>* node, std::function<void(T)> action) const {
+    auto visit = [&action](const T& value) {
+        try {
+            action(value); // Обработка текущего узла
+        }
+        catch (...) {
+            throw TreeException("Action failed during ReversePostOrder traversal");
+        }
+    };
+    VisitSubtree<TraversalType::REVERSE_POST_ORDER>(node, visit);
+}
+
+
+// Трансформация значений (применение функции-маппера к каждому элементу исходного дерева)
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::map(std::function<T(T)> mapper) const {
+    // Валидация переданной функции
+    if (!mapper) {
+        throw TreeException("Mapper function cannot be null");
     }
-    PostOrder(node->left, action); // Левое поддерево
-    PostOrder(node->right, action); // Правое поддерево
-    
+
+    BinaryTree<T, Compare, Allocator> result = EmptyLike(); // Пустое дерево с теми же балансировкой, компаратором и аллокатором
+    if (!root) {
+        return result; // Возврат пустого дерева
+    }
+
     try {
-        action(node->data); // Текущий узел
+        // Oбход PreOrder для сохранения структуры
+        ForEach<TraversalType::PRE_ORDER>([&](const T& value) {
+            try {
+                result.Insert(mapper(value)); // Результат маппера перемещается в новый узел
+            }
+            catch (...) {
+                throw TreeException("Mapper function execution failed");
+            }
+        });
+    }
+    catch (const TreeException&) {
+        throw; // Далее
     }
     catch (...) {
-        throw TreeException("Action failed during PostOrder traversal");
+        throw TreeException("Unknown error during map operation");
     }
+
+    return result;
 }
 
-// Обратный обратный обход (Право → Лево → Корень)
-// Параметры: текущий узел, функция обработки
-template <typename T>
-void BinaryTree<T>::ReversePostOrder(Node<T>* node, std::function<void(T)> action) const {
-    // Базовый случай рекурсии (выход)
-    if (!node) {
-        return;
+// Фильтрация элементов (Создание нового дерева, включающего только те элементы, которые удовлетворяют условию)
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::where(std::function<bool(T)> predicate) const {
+    // Валидация переданной функции
+    if (!predicate) {
+        throw TreeException("Predicate function cannot be null");
+    }
+
+    BinaryTree<T, Compare, Allocator> result = EmptyLike(); // Пустое дерево с теми же балансировкой, компаратором и аллокатором
+    if (!root) {
+        return result; // Возврат пустого дерева
     }
-    ReversePostOrder(node->right, action); // Правое поддерево
-    ReversePostOrder(node->left, action); // Левое поддерево
-    
     try {
-        action(node->data); // Текущий узел
+        ForEach<TraversalType::IN_ORDER>([&](const T& value) {
+            try {
+                if (predicate(value)) { // Проверка условия
+                    result.Insert(value); // Вставка при соответствии
+                }
+            }
+            catch (...) {
+                throw TreeException("Predicate function execution failed");
+            }
+        });
+    }
+    catch (const TreeException&) {
+        throw;
     }
     catch (...) {
-        throw TreeException("Action failed during ReversePostOrder traversal");
+        throw TreeException("Unknown error during where operation");
+    }
+
+    return result;
+}
+
+// Деление работы по поддеревьям
+// Узлы верхних уровней (до границы) - куски из одного значения, поддеревья на границе - куски целиком.
+// Кусок с корнем в позиции h неявного полного дерева порождает задачи для позиций 2h и 2h+1,
+// поэтому порядок кусков восстанавливается обходом eytzinger::First/Next - это симметричный порядок.
+// Граница - около 8 кусков-поддеревьев на поток: неравные поддеревья выравниваются перехватом задач
+template <typename T, typename Compare, typename Allocator>
+template <typename Process>
+std::vector<std::vector<T>> BinaryTree<T, Compare, Allocator>::ProcessParallel(WorkStealingPool& workers, bool sortPieces,
+                                                                     Process process) const {
+    size_t levels = 1;
+    while ((size_t(1) << levels) < 8 * static_cast<size_t>(workers.ThreadCount())) {
+        ++levels;
+    }
+    const size_t boundary = size_t(1) << levels;  // Первая позиция на границе
+    const size_t positions = 2 * boundary - 1;
+    std::vector<std::vector<T>> pieces(positions + 1);
+
+    std::function<void(size_t, Node<T>*)> spawn = [&](size_t position, Node<T>* node) {
+        if (!node) {
+            return;
+        }
+        workers.Submit([&, position, node]() {
+            std::vector<T>& piece = pieces[position];
+            if (position >= boundary) {
+                auto visit = [&piece, &process](const T& value) { process(value, piece); };
+                VisitSubtree<TraversalType::IN_ORDER>(node, visit);
+                if (sortPieces) {
+                    std::sort(piece.begin(), piece.end(), compare);
+                }
+            } else {
+                spawn(2 * position, node->left);
+                spawn(2 * position + 1, node->right);
+                process(node->data, piece);
+            }
+        });
+    };
+    spawn(1, root);
+    workers.Wait();
+
+    // Куски в симметричном порядке
+    std::vector<std::vector<T>> ordered;
+    for (size_t k = eytzinger::First(positions); k != 0; k = eytzinger::Next(k, positions)) {
+        if (!pieces[k].empty()) {
+            ordered.push_back(std::move(pieces[k]));
+        }
     }
+    return ordered;
 }
 
-
-// Трансформация значений (применение функции-маппера к каждому элементу исходного дерева)
-template <typename T>
-BinaryTree<T> BinaryTree<T>::map(std::function<T(T)> mapper) const {
-    // Валидация переданной функции
+// Параллельное преобразование
+// Куски отсортированы в своих задачах, затем сливаются попарно (раунды слияний - тоже задачи пула)
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::parallelMap(std::function<T(T)> mapper, unsigned threads) const {
     if (!mapper) {
         throw TreeException("Mapper function cannot be null");
     }
-
-    BinaryTree<T> result; // Создание пустого дерева result для результатов
+    BinaryTree<T, Compare, Allocator> result = EmptyLike();
     if (!root) {
-        return result; // Возврат пустого дерева
+        return result;
     }
 
+    WorkStealingPool workers(threads);
+    std::vector<std::vector<T>> runs;
     try {
-        // Oбход PreOrder для сохранения структуры
-        Traverse(TraversalType::PRE_ORDER, [&](const T& value) {
+        runs = ProcessParallel(workers, true, [&mapper](const T& value, std::vector<T>& out) {
             try {
-                T newValue = mapper(value); // Применение маппера
-                result.Insert(newValue); // Добавление в новое дерево
+                out.push_back(mapper(value));
             }
             catch (...) {
                 throw TreeException("Mapper function execution failed");
             }
         });
+        while (runs.size() > 1) {
+            std::vector<std::vector<T>> merged((runs.size() + 1) / 2);
+            for (size_t i = 0; i + 1 < runs.size(); i += 2) {
+                workers.Submit([this, &runs, &merged, i]() {
+                    std::vector<T>& target = merged[i / 2];
+                    target.reserve(runs[i].size() + runs[i + 1].size());
+                    std::merge(runs[i].begin(), runs[i].end(), runs[i + 1].begin(), runs[i + 1].end(),
+                               std::back_inserter(target), compare);
+                    std::vector<T>().swap(runs[i]);
+                    std::vector<T>().swap(runs[i + 1]);
+                });
+            }
+            if (runs.size() % 2 == 1) {
+                merged.back() = std::move(runs.back());
+            }
+            workers.Wait();
+            runs = std::move(merged);
+        }
     }
     catch (const TreeException&) {
-        throw; // Далее
+        throw;
     }
     catch (...) {
-        throw TreeException("Unknown error during map operation");
+        throw TreeException("Unknown error during parallel map operation");
     }
 
+    std::vector<T>& values = runs.front();
+    values.erase(std::unique(values.begin(), values.end(),
+                             [this](const T& a, const T& b) { return KeyEquivalent(compare, a, b); }),
+                 values.end()); // Преобразование могло склеить значения
+    result.AssignSorted(std::move(values));
     return result;
 }
 
-// Фильтрация элементов (Создание нового дерева, включающего только те элементы, которые удовлетворяют условию)
-template <typename T>
-BinaryTree<T> BinaryTree<T>::where(std::function<bool(T)> predicate) const {
-    // Валидация переданной функции
+// Параллельная фильтрация: отфильтрованные куски уже идут по возрастанию, достаточно склеить их
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::parallelWhere(std::function<bool(T)> predicate, unsigned threads) const {
     if (!predicate) {
         throw TreeException("Predicate function cannot be null");
     }
-
-    BinaryTree<T> result; // Создание пустого дерева result для результатов
+    BinaryTree<T, Compare, Allocator> result = EmptyLike();
     if (!root) {
-        return result; // Возврат пустого дерева
+        return result;
     }
+
+    WorkStealingPool workers(threads);
+    std::vector<std::vector<T>> pieces;
     try {
-        Traverse(TraversalType::IN_ORDER, [&](const T& value) {
+        pieces = ProcessParallel(workers, false, [&predicate](const T& value, std::vector<T>& out) {
+            bool keep;
             try {
-                if (predicate(value)) { // Проверка условия
-                    result.Insert(value); // Вставка при соответствии
-                }
+                keep = predicate(value);
             }
             catch (...) {
                 throw TreeException("Predicate function execution failed");
             }
+            if (keep) {
+                out.push_back(value);
+            }
         });
     }
     catch (const TreeException&) {
         throw;
     }
     catch (...) {
-        throw TreeException("Unknown error during where operation");
+        throw TreeException("Unknown error during parallel where operation");
     }
 
+    size_t total = 0;
+    for (const std::vector<T>& piece : pieces) {
+        total += piece.size();
+    }
+    std::vector<T> values;
+    values.reserve(total);
+    for (std::vector<T>& piece : pieces) {
+        values.insert(values.end(), std::make_move_iterator(piece.begin()), std::make_move_iterator(piece.end()));
+    }
+    result.AssignSorted(std::move(values));
     return result;
 }
 
-// Cлияние деревьев (создание нового)
-template <typename T>
-BinaryTree<T> BinaryTree<T>::merge(const BinaryTree<T>& other) const {
-    BinaryTree<T> result = *this; // Копирование текущего дерева
+// Все значения дерева по возрастанию
+template <typename T, typename Compare, typename Allocator>
+std::vector<T> BinaryTree<T, Compare, Allocator>::ToSortedVector() const {
+    std::vector<T> values;
+    values.reserve(nodeCount);
+    ForEach<TraversalType::IN_ORDER>([&values](const T& value) { values.push_back(value); });
+    return values;
+}
 
-    try {
-        // Добавление всех элементов из другого дерева (проходит по всем элементам второго дерева)
-        other.Traverse(TraversalType::IN_ORDER, [&](const T& value) {
-            try {
-                result.Insert(value); // Попытка вставить каждый элемент
-            }
-            catch (const TreeException& e) {
-                // Игнор дубликатов
-                // Ошибки вставки логируются, но не прерывают процесс
-                std::cerr << "Merge warning: " << e.what() << std::endl;
-            }
-            catch (...) {
-                throw TreeException("Insertion failed during merge");
-            }
-        });
+// Построение идеально сбалансированного поддерева из отсортированных уникальных значений
+// Корень - средний элемент, половины строятся так же; глубина рекурсии O(log n)
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::BuildBalanced(T* values, size_t count) {
+    if (count == 0) {
+        return nullptr;
     }
-    catch (const TreeException&) {
-        throw;
+    size_t middle = count / 2;
+    Node<T>* node = CreateNode(std::move(values[middle]));
+    node->left = BuildBalanced(values, middle);
+    node->right = BuildBalanced(values + middle + 1, count - middle - 1);
+    UpdateNode(node); // Высота и размер поддерева корректны сразу - дерево годится и для AVL
+    return node;
+}
+
+// Замена содержимого дерева сбалансированным деревом из отсортированных уникальных значений
+// Память под все узлы резервируется в пуле одним блоком
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::AssignSorted(std::vector<T>&& values) {
+    Clear();
+    pool.Reserve(values.size());
+    try {
+        root = BuildBalanced(values.data(), values.size());
     }
-    catch (...) {
-        throw TreeException("Unknown error during merge operation");
+    catch (const std::bad_alloc&) {
+        Clear();
+        throw TreeException("Memory allocation failed while building balanced tree");
     }
+}
+
+// Пустое дерево с теми же настройками (балансировка, порядковые статистики, компаратор, аллокатор)
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::EmptyLike() const {
+    BinaryTree<T, Compare, Allocator> result(balance, compare, pool.GetAllocator());
+    result.orderStatistics = orderStatistics;
+    return result;
+}
+
+// Cлияние деревьев (создание нового)
+// Два симметричных обхода дают отсортированные последовательности, их слияние - за O(n + m),
+// результат строится сразу сбалансированным без повторных Insert. Дубликаты попадают один раз
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::merge(const BinaryTree<T, Compare, Allocator>& other) const {
+    return setUnion(other);
+}
 
+// Объединение множеств значений
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::setUnion(const BinaryTree<T, Compare, Allocator>& other) const {
+    std::vector<T> ours = ToSortedVector();
+    std::vector<T> theirs = other.ToSortedVector();
+    std::vector<T> merged;
+    merged.reserve(ours.size() + theirs.size());
+    std::set_union(ours.begin(), ours.end(), theirs.begin(), theirs.end(), std::back_inserter(merged), compare);
+
+    BinaryTree<T, Compare, Allocator> result = EmptyLike();
+    result.AssignSorted(std::move(merged));
     return result;  // Возврат обьединенного дерева
 }
 
+// Пересечение: значения, которые есть в обоих деревьях
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::setIntersection(const BinaryTree<T, Compare, Allocator>& other) const {
+    std::vector<T> ours = ToSortedVector();
+    std::vector<T> theirs = other.ToSortedVector();
+    std::vector<T> common;
+    common.reserve(std::min(ours.size(), theirs.size()));
+    std::set_intersection(ours.begin(), ours.end(), theirs.begin(), theirs.end(), std::back_inserter(common), compare);
+
+    BinaryTree<T, Compare, Allocator> result = EmptyLike();
+    result.AssignSorted(std::move(common));
+    return result;
+}
+
+// Разность: значения этого дерева, которых нет в other
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::setDifference(const BinaryTree<T, Compare, Allocator>& other) const {
+    std::vector<T> ours = ToSortedVector();
+    std::vector<T> theirs = other.ToSortedVector();
+    std::vector<T> rest;
+    rest.reserve(ours.size());
+    std::set_difference(ours.begin(), ours.end(), theirs.begin(), theirs.end(), std::back_inserter(rest), compare);
+
+    BinaryTree<T, Compare, Allocator> result = EmptyLike();
+    result.AssignSorted(std::move(rest));
+    return result;
+}
+
 
 
 // Извлечение поддерева (Создание новое дерева, которое является копией поддерева, начиная с узла с указанным значением)
-template <typename T>
-BinaryTree<T> BinaryTree<T>::extractSubtree(const T& value) const {
+template <typename T, typename Compare, typename Allocator>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::extractSubtree(const T& value) const {
     // Нахождение узела-кореня поддерева
     Node<T>* subtreeRoot = FindNode(root, value);
     
@@ -755,10 +1444,10 @@ BinaryTree<T> BinaryTree<T>::extractSubtree(const T& value) const {
         throw NodeNotFound("Value not found in tree - cannot extract subtree");
     }
 
-    BinaryTree<T> result;
+    BinaryTree<T, Compare, Allocator> result = EmptyLike(); // Размеры поддеревьев копируются вместе с узлами
     try {
         // Копирование поддерева начиная с найденного узла
-        result.root = Copy(subtreeRoot);
+        result.root = result.Copy(subtreeRoot); // Узлы выделяются в пуле результата
     }
     catch (const std::bad_alloc&) {
         throw TreeException("Memory allocation failed during subtree extraction");
@@ -772,8 +1461,8 @@ BinaryTree<T> BinaryTree<T>::extractSubtree(const T& value) const {
 }
 
 // Проверка наличия поддерева
-template <typename T>
-bool BinaryTree<T>::containsSubtree(const BinaryTree<T>& subtree) const {
+template <typename T, typename Compare, typename Allocator>
+bool BinaryTree<T, Compare, Allocator>::containsSubtree(const BinaryTree<T, Compare, Allocator>& subtree) const {
     // Проверка на пустое поддерево
     if (subtree.IsEmpty()) {
         throw TreeException("Cannot search for empty subtree");
@@ -797,28 +1486,33 @@ bool BinaryTree<T>::containsSubtree(const BinaryTree<T>& subtree) const {
 }
 
 // Функция сравнения дереьвев (сугубо вспомогательная)
-template <typename T>
-bool BinaryTree<T>::CompareSubtrees(Node<T>* ourNode, Node<T>* subNode) const {
-    // Базовый случай: если поддерево закончилось
-    if (!subNode) {
-        return true;
-    }
-    // Если наше дерево закончилось, а поддерево - нет
-    if (!ourNode) {
-        return false;
+// Поддерево subNode должно совпасть с началом поддерева ourNode (пары сравниваются на явном стеке)
+template <typename T, typename Compare, typename Allocator>
+bool BinaryTree<T, Compare, Allocator>::CompareSubtrees(Node<T>* ourNode, Node<T>* subNode) const {
+    std::vector<std::pair<Node<T>*, Node<T>*>> pairs{{ourNode, subNode}};
+    while (!pairs.empty()) {
+        auto [ours, sub] = pairs.back();
+        pairs.pop_back();
+        // Поддерево закончилось - эта ветка совпала
+        if (!sub) {
+            continue;
+        }
+        // Если наше дерево закончилось, а поддерево - нет
+        if (!ours || !KeyEquivalent(compare, ours->data, sub->data)) {
+            return false;
+        }
+        pairs.push_back({ours->right, sub->right});
+        pairs.push_back({ours->left, sub->left});
     }
-    // Сравнение значений и рекурсивная проверка потомков
-    return (ourNode->data == subNode->data) &&
-           CompareSubtrees(ourNode->left, subNode->left) &&
-           CompareSubtrees(ourNode->right, subNode->right);
+    return true;
 }
 
 
 
 // Получение значения по абсолютному пути от корня
 // path - вектор направлений ("left"/"right")
-template <typename T>
-T BinaryTree<T>::GetByPath(const std::vector<std::string>& path) const {
+template <typename T, typename Compare, typename Allocator>
+T BinaryTree<T, Compare, Allocator>::GetByPath(const std::vector<std::string>& path) const {
     Node<T>* current = root;  // Старт с корня дерева
     
     // Проверка на пустое дерево
@@ -853,8 +1547,8 @@ T BinaryTree<T>::GetByPath(const std::vector<std::string>& path) const {
 // Получение значения по относительному пути от узла с указанным значением
 // base - значение базового узла
 // вектор направлений ("left"/"right")
-template <typename T>
-T BinaryTree<T>::GetByRelativePath(const T& base, const std::vector<std::string>& path) const {
+template <typename T, typename Compare, typename Allocator>
+T BinaryTree<T, Compare, Allocator>::GetByRelativePath(const T& base, const std::vector<std::string>& path) const {
     // Нахождение базового узла
     Node<T>* baseNode = FindNode(root, base);
     // Не существует
@@ -891,32 +1585,12 @@ T BinaryTree<T>::GetByRelativePath(const T& base, const std::vector<std::string>
 
 
 // Сериализация дерева в строку
-template <typename T>
-std::string BinaryTree<T>::serialize(TraversalType type) const {
+template <typename T, typename Compare, typename Allocator>
+std::string BinaryTree<T, Compare, Allocator>::serialize(TraversalType type) const {
     std::string result;
+    TokenWriter writer(result);
     try {
-        switch (type) {
-            case TraversalType::PRE_ORDER:
-                SerializePreOrder(root, result);
-                break;
-            case TraversalType::REVERSE_PRE_ORDER:
-                SerializeReversePreOrder(root, result);
-                break;
-            case TraversalType::IN_ORDER:
-                SerializeInOrder(root, result);
-                break;
-            case TraversalType::REVERSE_IN_ORDER:
-                SerializeReverseInOrder(root, result);
-                break;
-            case TraversalType::POST_ORDER:
-                SerializePostOrder(root, result);
-                break;
-            case TraversalType::REVERSE_POST_ORDER:
-                SerializeReversePostOrder(root, result);
-                break;
-            default:
-                throw TreeException("Unsupported serialization type");
-        }
+        SerializeText(writer, type);
     }
     catch (...) {
         throw TreeException("Serialization failed");
@@ -924,192 +1598,179 @@ std::string BinaryTree<T>::serialize(TraversalType type) const {
     return result;
 }
 
-// Сериализация в прямом порядке (Преобразует дерево в строку в порядке "Корень → Левое поддерево → Правое поддерево")
-template <typename T>
-void BinaryTree<T>::SerializePreOrder(Node<T>* node, std::string& result) const {
-    if (!node) {
-        result += "null ";  // Маркер отсутствия узла
-        return;
-    }
-    
+// Сериализация дерева в поток (текст уходит в поток порциями по STREAM_BUFFER_SIZE байт)
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::serialize(std::ostream& out, TraversalType type) const {
+    std::string buffer;
+    TokenWriter writer(buffer, &out);
     try {
-        if constexpr (std::is_same<T, std::string>::value) {
-        // Если data — это строка, просто добавляем её
-        result += node->data + " ";
-    } else {
-        // Если data — это не строка, преобразуем её в строку
-        result += std::to_string(node->data) + " ";
-    }  // Сериализация текущего узла
-        SerializePreOrder(node->left, result);       // Левое поддерево
-        SerializePreOrder(node->right, result);      // Правое поддерево
+        SerializeText(writer, type);
+        writer.Flush();
+        out.flush();
     }
     catch (...) {
-        throw TreeException("PreOrder serialization failed");
+        throw TreeException("Serialization failed");
+    }
+    if (!out) {
+        throw TreeException("Serialization failed: stream write error");
     }
 }
 
-// Сериализация в обратном прямом порядке (Преобразует дерево в строку в порядке "Корень → Правое поддерево → Левое поддерево")
-template <typename T>
-void BinaryTree<T>::SerializeReversePreOrder(Node<T>* node, std::string& result) const {
-    if (!node) {
-        result += "null ";
-        return;
+// Сериализация дерева в файловый дескриптор
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::serializeToFd(int fd, TraversalType type) const {
+    FdStreamBuf buffer(fd, std::ios_base::out);
+    std::ostream out(&buffer);
+    serialize(out, type);
+}
+
+// Запись всего дерева в выбранном порядке
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::SerializeText(TokenWriter& result, TraversalType type) const {
+    switch (type) {
+        case TraversalType::PRE_ORDER:
+            SerializePreOrder(root, result);
+            break;
+        case TraversalType::REVERSE_PRE_ORDER:
+            SerializeReversePreOrder(root, result);
+            break;
+        case TraversalType::IN_ORDER:
+            SerializeInOrder(root, result);
+            break;
+        case TraversalType::REVERSE_IN_ORDER:
+            SerializeReverseInOrder(root, result);
+            break;
+        case TraversalType::POST_ORDER:
+            SerializePostOrder(root, result);
+            break;
+        case TraversalType::REVERSE_POST_ORDER:
+            SerializeReversePostOrder(root, result);
+            break;
+        default:
+            throw TreeException("Unsupported serialization type");
     }
-    
-    try {
-        if constexpr (std::is_same<T, std::string>::value) {
+}
+
+// Добавление значения узла в строку сериализации
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::AppendToken(const T& value, TokenWriter& result) {
+    if constexpr (std::is_same<T, std::string>::value) {
         // Если data — это строка, просто добавляем её
-        result += node->data + " ";
+        result += value;
     } else {
         // Если data — это не строка, преобразуем её в строку
-        result += std::to_string(node->data) + " ";
-    }  // Текущий узел
-        SerializeReversePreOrder(node->right, result); // Правое поддерево
-        SerializeReversePreOrder(node->left, result);  // Левое поддерево
-    }
-    catch (...) {
-        throw TreeException("ReversePreOrder serialization failed");
+        result += std::to_string(value);
     }
+    result += ' ';
+}
+
+// Сериализация в прямом порядке (Преобразует дерево в строку в порядке "Корень → Левое поддерево → Правое поддерево")
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::SerializePreOrder(Node<T>* node, TokenWriter& result) const {
+    auto onNode = [&result](const T& value) { AppendToken(value, result); };
+    auto onNull = [&result]() { result += "null "; }; // Маркер отсутствия узла
+    WalkSubtree<TraversalType::PRE_ORDER, true>(node, onNode, onNull);
+}
+
+// Сериализация в обратном прямом порядке (Преобразует дерево в строку в порядке "Корень → Правое поддерево → Левое поддерево")
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::SerializeReversePreOrder(Node<T>* node, TokenWriter& result) const {
+    auto onNode = [&result](const T& value) { AppendToken(value, result); };
+    auto onNull = [&result]() { result += "null "; }; // Маркер отсутствия узла
+    WalkSubtree<TraversalType::REVERSE_PRE_ORDER, true>(node, onNode, onNull);
 }
 
 // Сериализация в симметричном порядке (Преобразует дерево в строку в порядке "Левое поддерево → Корень → Правое поддерево")
-template <typename T>
-void BinaryTree<T>::SerializeInOrder(Node<T>* node, std::string& result) const {
-    if (!node) {
-        result += "null ";
-        return;
-    }
-    
-    try {
-        SerializeInOrder(node->left, result);       // Левое поддерево
-        if constexpr (std::is_same<T, std::string>::value) {
-        // Если data — это строка, просто добавляем её
-        result += node->data + " ";
-    } else {
-        // Если data — это не строка, преобразуем её в строку
-        result += std::to_string(node->data) + " ";
-    } // Текущий узел
-        SerializeInOrder(node->right, result);      // Правое поддерево
-    }
-    catch (...) {
-        throw TreeException("InOrder serialization failed");
-    }
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::SerializeInOrder(Node<T>* node, TokenWriter& result) const {
+    auto onNode = [&result](const T& value) { AppendToken(value, result); };
+    auto onNull = [&result]() { result += "null "; }; // Маркер отсутствия узла
+    WalkSubtree<TraversalType::IN_ORDER, true>(node, onNode, onNull);
 }
 
-//  Сериализация в обратном симметричном порядке (Преобразует дерево в строку в порядке "Правое поддерево → Корень → Левое поддерево")
-template <typename T>
-void BinaryTree<T>::SerializeReverseInOrder(Node<T>* node, std::string& result) const {
-    if (!node) {
-        result += "null ";
-        return;
-    }
-    
-    try {
-        SerializeReverseInOrder(node->right, result); // Правое поддерево
-        if constexpr (std::is_same<T, std::string>::value) {
-        // Если data — это строка, просто добавляем её
-        result += node->data + " ";
-    } else {
-        // Если data — это не строка, преобразуем её в строку
-        result += std::to_string(node->data) + " ";
-    }  // Текущий узел
-        SerializeReverseInOrder(node->left, result);  // Левое поддерево
-    }
-    catch (...) {
-        throw TreeException("ReverseInOrder serialization failed");
-    }
+// Сериализация в обратном симметричном порядке (Преобразует дерево в строку в порядке "Правое поддерево → Корень → Левое поддерево")
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::SerializeReverseInOrder(Node<T>* node, TokenWriter& result) const {
+    auto onNode = [&result](const T& value) { AppendToken(value, result); };
+    auto onNull = [&result]() { result += "null "; }; // Маркер отсутствия узла
+    WalkSubtree<TraversalType::REVERSE_IN_ORDER, true>(node, onNode, onNull);
 }
 
 // Сериализация в обратном порядке (Преобразует дерево в строку в порядке "Левое поддерево → Правое поддерево → Корень")
-template <typename T>
-void BinaryTree<T>::SerializePostOrder(Node<T>* node, std::string& result) const {
-    if (!node) {
-        result += "null ";
-        return;
-    }
-    
-    
-        SerializePostOrder(node->left, result);      // Левое поддерево
-        SerializePostOrder(node->right, result);     // Правое поддерево
-        if constexpr (std::is_same<T, std::string>::value) {
-        // Если data — это строка, просто добавляем её
-        result += node->data + " ";
-    } else {
-        // Если data — это не строка, преобразуем её в строку
-        result += std::to_string(node->data) + " ";
-    }
-    
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::SerializePostOrder(Node<T>* node, TokenWriter& result) const {
+    auto onNode = [&result](const T& value) { AppendToken(value, result); };
+    auto onNull = [&result]() { result += "null "; }; // Маркер отсутствия узла
+    WalkSubtree<TraversalType::POST_ORDER, true>(node, onNode, onNull);
 }
 
 // Сериализация в обратном обратном порядке (Преобразует дерево в строку в порядке "Правое поддерево → Левое поддерево → Корень")
-template <typename T>
-void BinaryTree<T>::SerializeReversePostOrder(Node<T>* node, std::string& result) const {
-    if (node == nullptr) {
-        return;  // Если узел пустой, ничего не делаем
-    }
-
-    // Сначала сериализуем правое поддерево
-    SerializeReversePostOrder(node->right, result);
-    
-    // Потом сериализуем левое поддерево
-    SerializeReversePostOrder(node->left, result);
-    
-    // Сериализуем текущий узел
-    if constexpr (std::is_same<T, std::string>::value) {
-        // Если data — это строка, просто добавляем её
-        result += node->data + " ";
-    } else {
-        // Если data — это не строка, преобразуем её в строку
-        result += std::to_string(node->data) + " ";
-    }
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::SerializeReversePostOrder(Node<T>* node, TokenWriter& result) const {
+    auto onNode = [&result](const T& value) { AppendToken(value, result); };
+    auto onNull = [&result]() { result += "null "; }; // Маркер отсутствия узла
+    WalkSubtree<TraversalType::REVERSE_POST_ORDER, true>(node, onNode, onNull);
 }
 
 
 
 
 // Десериализация дерева из строки
-template <typename T>
-void BinaryTree<T>::deserialize(const std::string& data, TraversalType type) {
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::deserialize(const std::string& data, TraversalType type) {
+    // Токены читаются прямо из строки, без копии данных
+    MemoryStreamBuf buffer(data.data(), data.size());
+    std::istream in(&buffer);
+    deserialize(in, type);
+}
+
+// Десериализация дерева из файлового дескриптора
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::deserializeFromFd(int fd, TraversalType type) {
+    FdStreamBuf buffer(fd, std::ios_base::in);
+    std::istream in(&buffer);
+    deserialize(in, type);
+}
+
+// Десериализация дерева из потока
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::deserialize(std::istream& input, TraversalType type) {
     Clear(); // Очистка текущего дерева
-    
-    // Разбиение строки на токены
-    std::queue<std::string> elements;
-    std::istringstream iss(data);
-    std::string token;
-    
-    while (iss >> token) { // Считывание токенов из строки
-        elements.push(token);
-    }
 
     try {
         // Выбор метода десериализации
         switch (type) {
             case TraversalType::PRE_ORDER:
-                root = DeserializePreOrder(elements);
+                root = DeserializePreOrder(input);
                 break;
             case TraversalType::REVERSE_PRE_ORDER:
-                root = DeserializeReversePreOrder(elements);
+                root = DeserializeReversePreOrder(input);
                 break;
             case TraversalType::IN_ORDER:
-                root = DeserializeInOrder(elements);
+                root = DeserializeInOrder(input);
                 break;
             case TraversalType::REVERSE_IN_ORDER:
-                root = DeserializeReverseInOrder(elements);
+                root = DeserializeReverseInOrder(input);
                 break;
             case TraversalType::POST_ORDER:
-                root = DeserializePostOrder(elements);
+                root = DeserializePostOrder(input);
                 break;
             case TraversalType::REVERSE_POST_ORDER:
-                root = DeserializeReversePostOrder(elements);
+                root = DeserializeReversePostOrder(input);
                 break;
             default:
                 throw TreeException("Unsupported deserialization type");
         }
         
         // Проверка лишних токенов
-        if (!elements.empty()) {
+        std::string token;
+        if (input >> token) {
             throw TreeException("Extra data in input string");
         }
+        // Форма задана входными данными - высоты и размеры нужно посчитать заново
+        if (TracksPath()) {
+            RefreshMetadata(root);
+        }
     }
     catch (...) {
         Clear(); // В случае ошибки очистка дерева
@@ -1118,81 +1779,89 @@ void BinaryTree<T>::deserialize(const std::string& data, TraversalType type) {
 }
 
 // Десериализация дерева из PreOrder представления
-// elements - очередь токенов ("значение" или "null")
-template <typename T>
-Node<T>* BinaryTree<T>::DeserializePreOrder(std::queue<std::string>& elements) {
-    if (elements.empty()) {
-        return nullptr; // Нет данных - возврат nullptr
-    }
-    std::string token = elements.front(); // Следующий токен
-    elements.pop();
-    
-    if (token == "null") {
-        return nullptr; // Токен "null" означает пустой узел
-    }
-    try {
-        T value;
-        std::istringstream(token) >> value; // Парсинг значения
-        Node<T>* node = new Node<T>(value); // Создание узла
-        
-        // Рекурсивное строительство поддеревьев
-        node->left = DeserializePreOrder(elements);
-        node->right = DeserializePreOrder(elements);
-        
-        return node;
-    }
-    catch (...) {
-        throw TreeException("Invalid node data: " + token);
+// input - поток токенов ("значение" или "null")
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::DeserializePreOrder(std::istream& input) {
+    Node<T>* result = nullptr;
+    // Стек пустых ссылок, которые ещё предстоит заполнить (вершина - следующая по порядку)
+    std::vector<Node<T>**> slots{&result};
+    std::string token;
+    while (!slots.empty() && input >> token) { // Нет данных - оставшиеся ссылки остаются nullptr
+        Node<T>** slot = slots.back();
+        slots.pop_back();
+
+        if (token == "null") {
+            continue; // Токен "null" означает пустой узел
+        }
+        try {
+            T value;
+            std::istringstream(token) >> value; // Парсинг значения
+            *slot = CreateNode(std::move(value)); // Создание узла
+        }
+        catch (...) {
+            Clear(result);
+            throw TreeException("Invalid node data: " + token);
+        }
+
+        // Поддеревья строятся в порядке появления в строке
+        slots.push_back(&(*slot)->right);
+        slots.push_back(&(*slot)->left);
     }
+    return result;
 }
 
-template <typename T>
-Node<T>* BinaryTree<T>::DeserializeReversePreOrder(std::queue<std::string>& elements) {
-    if (elements.empty()) return nullptr;
-    
-    std::string token = elements.front();
-    elements.pop();
-    
-    if (token == "null") return nullptr;
-    
-    try {
-        T value;
-        std::istringstream(token) >> value;
-        Node<T>* node = new Node<T>(value);
-        
-        // Сначала правое, затем левое поддерево
-        node->right = DeserializeReversePreOrder(elements);
-        node->left = DeserializeReversePreOrder(elements);
-        
-        return node;
-    }
-    catch (...) {
-        throw TreeException("Invalid node data: " + token);
+// Десериализация дерева из ReversePreOrder представления (сначала правое, затем левое поддерево)
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::DeserializeReversePreOrder(std::istream& input) {
+    Node<T>* result = nullptr;
+    // Стек пустых ссылок, которые ещё предстоит заполнить (вершина - следующая по порядку)
+    std::vector<Node<T>**> slots{&result};
+    std::string token;
+    while (!slots.empty() && input >> token) { // Нет данных - оставшиеся ссылки остаются nullptr
+        Node<T>** slot = slots.back();
+        slots.pop_back();
+
+        if (token == "null") {
+            continue; // Токен "null" означает пустой узел
+        }
+        try {
+            T value;
+            std::istringstream(token) >> value; // Парсинг значения
+            *slot = CreateNode(std::move(value)); // Создание узла
+        }
+        catch (...) {
+            Clear(result);
+            throw TreeException("Invalid node data: " + token);
+        }
+
+        // Поддеревья строятся в порядке появления в строке
+        slots.push_back(&(*slot)->left);
+        slots.push_back(&(*slot)->right);
     }
+    return result;
 }
 
-template <typename T>
-Node<T>* BinaryTree<T>::DeserializeInOrder(std::queue<std::string>& elements) {
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::DeserializeInOrder(std::istream& input) {
     // InOrder десериализация требует дополнительной информации
     // В реальных проектах обычно используется комбинация InOrder+PreOrder
     throw TreeException("InOrder deserialization not supported alone");
 }
 
-template <typename T>
-Node<T>* BinaryTree<T>::DeserializeReverseInOrder(std::queue<std::string>& elements) {
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::DeserializeReverseInOrder(std::istream& input) {
     // ReverseInOrder десериализация требует дополнительной информации
     // В реальных проектах обычно используется комбинация ReverseInOrder+PreOrder
     throw TreeException("ReverseInOrder deserialization not supported alone");
 }
 
 // Десериализация дерева из PostOrder представления
-template <typename T>
-Node<T>* BinaryTree<T>::DeserializePostOrder(std::queue<std::string>& elements) {
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::DeserializePostOrder(std::istream& input) {
     std::stack<Node<T>*> nodeStack;
     
-    while (!elements.empty()) {
-        std::string token = elements.front();
-        elements.pop();
+    std::string token;
+    while (input >> token) {
         
         if (token == "null") {
             nodeStack.push(nullptr);
@@ -1201,7 +1870,7 @@ Node<T>* BinaryTree<T>::DeserializePostOrder(std::queue<std::string>& elements)
             try {
                 T value;
                 std::istringstream(token) >> value;
-                Node<T>* node = new Node<T>(value);
+                Node<T>* node = CreateNode(std::move(value));
                 
                 // Для PostOrder правый потомок идет первым в стеке
                 node->right = nodeStack.top();
@@ -1214,7 +1883,7 @@ Node<T>* BinaryTree<T>::DeserializePostOrder(std::queue<std::string>& elements)
             catch (...) {
                 // Очистка стека перед выбрасыванием исключения
                 while (!nodeStack.empty()) {
-                    delete nodeStack.top();
+                    Clear(nodeStack.top());
                     nodeStack.pop();
                 }
                 throw TreeException("Invalid node data: " + token);
@@ -1229,13 +1898,12 @@ Node<T>* BinaryTree<T>::DeserializePostOrder(std::queue<std::string>& elements)
     return nodeStack.top();
 }
 
-template <typename T>
-Node<T>* BinaryTree<T>::DeserializeReversePostOrder(std::queue<std::string>& elements) {
+template <typename T, typename Compare, typename Allocator>
+Node<T>* BinaryTree<T, Compare, Allocator>::DeserializeReversePostOrder(std::istream& input) {
     std::stack<Node<T>*> nodeStack;
     
-    while (!elements.empty()) {
-        std::string token = elements.front();
-        elements.pop();
+    std::string token;
+    while (input >> token) {
         
         if (token == "null") {
             nodeStack.push(nullptr);
@@ -1244,7 +1912,7 @@ Node<T>* BinaryTree<T>::DeserializeReversePostOrder(std::queue<std::string>& ele
             try {
                 T value;
                 std::istringstream(token) >> value;
-                Node<T>* node = new Node<T>(value);
+                Node<T>* node = CreateNode(std::move(value));
                 
                 // Для ReversePostOrder сначала левый потомок (так как порядок обратный)
                 node->left = nodeStack.top();
@@ -1257,7 +1925,7 @@ Node<T>* BinaryTree<T>::DeserializeReversePostOrder(std::queue<std::string>& ele
             catch (...) {
                 // Очистка стека при ошибке
                 while (!nodeStack.empty()) {
-                    delete nodeStack.top();
+                    Clear(nodeStack.top());
                     nodeStack.pop();
                 }
                 throw TreeException("Invalid node data: " + token);
@@ -1268,7 +1936,7 @@ Node<T>* BinaryTree<T>::DeserializeReversePostOrder(std::queue<std::string>& ele
     if (nodeStack.size() != 1) {
         // Очистка памяти при неверном формате
         while (!nodeStack.empty()) {
-            delete nodeStack.top();
+            Clear(nodeStack.top());
             nodeStack.pop();
         }
         throw TreeException("Invalid ReversePostOrder sequence");
@@ -1278,9 +1946,202 @@ Node<T>* BinaryTree<T>::DeserializeReversePostOrder(std::queue<std::string>& ele
 }
 
 
+// Запись дерева в двоичном формате
+// Прямой обход на явном стеке: у каждого узла вместе со значением записываются биты формы
+template <typename T, typename Compare, typename Allocator>
+template <typename Sink>
+void BinaryTree<T, Compare, Allocator>::WriteBinary(Sink& sink) const {
+    using Codec = binary_format::KeyCodec<T>;
+
+    sink.Write(binary_format::MAGIC, sizeof(binary_format::MAGIC));
+    sink.Put(binary_format::VERSION);
+    sink.Put(Codec::TAG);
+    binary_format::WriteVarint(sink, nodeCount);
+
+    typename Codec::State state;
+    std::vector<Node<T>*> nodeStack;
+    if (root) {
+        nodeStack.push_back(root);
+    }
+    while (!nodeStack.empty()) {
+        Node<T>* current = nodeStack.back();
+        nodeStack.pop_back();
+
+        uint8_t shape = (current->left ? binary_format::HAS_LEFT : 0) |
+                        (current->right ? binary_format::HAS_RIGHT : 0);
+        Codec::Write(sink, current->data, shape, state);
+
+        if (current->right) nodeStack.push_back(current->right);
+        if (current->left) nodeStack.push_back(current->left);
+    }
+}
+
+// Чтение дерева в двоичном формате
+// Стек хранит пустые ссылки, ожидающие узла: левая ссылка всегда на вершине (прямой порядок)
+template <typename T, typename Compare, typename Allocator>
+template <typename Source>
+void BinaryTree<T, Compare, Allocator>::ReadBinary(Source& source) {
+    using Codec = binary_format::KeyCodec<T>;
+    Clear();
+
+    char magic[sizeof(binary_format::MAGIC)];
+    source.Read(magic, sizeof(magic));
+    if (std::memcmp(magic, binary_format::MAGIC, sizeof(magic)) != 0) {
+        throw SerializationError("not a binary tree image");
+    }
+    uint8_t version = source.Get();
+    if (version != binary_format::VERSION) {
+        throw SerializationError("unsupported format version " + std::to_string(version));
+    }
+    if (source.Get() != Codec::TAG) {
+        throw SerializationError("key type does not match the tree");
+    }
+    uint64_t expected = binary_format::ReadVarint(source);
+
+    try {
+        // Все узлы - одним блоком пула; каждый узел занимает хотя бы байт,
+        // поэтому счётчику из заголовка верим не дальше оставшихся данных
+        pool.Reserve(source.Bound(expected));
+        typename Codec::State state;
+        std::vector<Node<T>**> slots;
+        if (expected > 0) {
+            slots.push_back(&root);
+        }
+        while (!slots.empty()) {
+            if (nodeCount == expected) {
+                throw SerializationError("more nodes than declared in the header");
+            }
+            Node<T>** slot = slots.back();
+            slots.pop_back();
+
+            uint8_t shape = 0;
+            *slot = CreateNode(Codec::Read(source, shape, state));
+            if (shape & ~binary_format::SHAPE_MASK) {
+                throw SerializationError("invalid node shape bits");
+            }
+            if (shape & binary_format::HAS_RIGHT) slots.push_back(&(*slot)->right);
+            if (shape & binary_format::HAS_LEFT) slots.push_back(&(*slot)->left);
+        }
+        if (nodeCount != expected) {
+            throw SerializationError("fewer nodes than declared in the header");
+        }
+    }
+    catch (...) {
+        Clear(); // Частично построенное дерево не оставляем
+        throw;
+    }
+
+    // Форма задана входными данными - высоты и размеры нужно посчитать заново
+    if (TracksPath()) {
+        RefreshMetadata(root);
+    }
+}
+
+// Сериализация в двоичный формат
+template <typename T, typename Compare, typename Allocator>
+std::string BinaryTree<T, Compare, Allocator>::serializeBinary() const {
+    std::string result;
+    binary_format::StringSink sink(result);
+    WriteBinary(sink);
+    return result;
+}
+
+// Десериализация из двоичного формата
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::deserializeBinary(const std::string& data) {
+    binary_format::MemorySource source(data.data(), data.size());
+    try {
+        ReadBinary(source);
+        if (!source.AtEnd()) {
+            throw SerializationError("extra data after the tree");
+        }
+    }
+    catch (const SerializationError&) {
+        Clear();
+        throw;
+    }
+    catch (const std::bad_alloc&) {
+        Clear();
+        throw TreeException("Memory allocation failed during binary deserialization");
+    }
+}
+
+// Двоичная сериализация в поток: байты пишутся прямо в буфер потока
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::serializeBinary(std::ostream& out) const {
+    binary_format::StreamSink sink(*out.rdbuf());
+    WriteBinary(sink);
+    if (!out.flush()) {
+        throw SerializationError("write to stream failed");
+    }
+}
+
+// Двоичная десериализация из потока
+// Образ дерева самоограничен: байты после него остаются в потоке непрочитанными
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::deserializeBinary(std::istream& in) {
+    binary_format::StreamSource source(*in.rdbuf());
+    try {
+        ReadBinary(source);
+    }
+    catch (const SerializationError&) {
+        Clear();
+        in.setstate(std::ios_base::failbit);
+        throw;
+    }
+    catch (const std::bad_alloc&) {
+        Clear();
+        throw TreeException("Memory allocation failed during binary deserialization");
+    }
+}
+
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::serializeBinaryToFd(int fd) const {
+    FdStreamBuf buffer(fd, std::ios_base::out);
+    std::ostream out(&buffer);
+    serializeBinary(out);
+}
+
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::deserializeBinaryFromFd(int fd) {
+    FdStreamBuf buffer(fd, std::ios_base::in);
+    std::istream in(&buffer);
+    deserializeBinary(in);
+}
+
+// Экспорт образа для отображения в память
+// Ключи раскладываются по слотам Эйтцингера прямо во время симметричного обхода, без копий значений
+template <typename T, typename Compare, typename Allocator>
+void BinaryTree<T, Compare, Allocator>::ExportImage(const std::string& path) const {
+    std::vector<const T*> slots(nodeCount + 1, nullptr);
+    size_t k = eytzinger::First(nodeCount);
+    for (const T& value : *this) {
+        slots[k] = &value;
+        k = eytzinger::Next(k, nodeCount);
+    }
+    mapped_image::WriteImage(path, slots);
+}
+
+// Снимок для чтения: значения копируются по возрастанию в массив Эйтцингера
+template <typename T, typename Compare, typename Allocator>
+FrozenBinaryTree<T, Compare> BinaryTree<T, Compare, Allocator>::Freeze() const {
+    return FrozenBinaryTree<T, Compare>(begin(), end(), compare);
+}
+
+// Начальная версия персистентного дерева: сбалансированное построение по возрастанию за O(n)
+template <typename T, typename Compare, typename Allocator>
+PersistentBinaryTree<T, Compare> BinaryTree<T, Compare, Allocator>::Persist() const {
+    return PersistentBinaryTree<T, Compare>(begin(), end(), compare);
+}
+
+
 // Явное инстанцирование шаблонов для нужных типов
 template class BinaryTree<int>;
 template class BinaryTree<float>;
 template class BinaryTree<std::string>;
 template class BinaryTree<double>;
 template class BinaryTree<std::complex<double>>;
+// Обратный порядок (нестандартный компаратор)
+template class BinaryTree<int, std::greater<int>>;
+// Аллокатор с состоянием
+template class BinaryTree<int, TreeLess<int>, CountingAllocator<int>>;
@@ -4,12 +4,23 @@
 #define BINARY_TREE_H
 
 #include "node.h"
+#include "node_pool.h"
+#include "tree_iterator.h"
+#include "parallel_sort.h"
+#include "work_stealing_pool.h"
 #include "exceptions.h"
+#include "tree_stream.h"
+#include "frozen_tree.h"
+#include "persistent_tree.h"
+#include "tree_stats.h"
+#include "tree_compare.h"
 #include <complex>
 #include <functional> // Предоставляет функциональные объекты и поддержку лямбда-выражений
 #include <vector> // Необходим для работы с путями в дереве (последовательность узлов)
 #include <string> // Необходим для сериализации/десериализации дерева
-#include <queue> // Предоставляет контейнеры std::queue (очередь) и std::priority_queue. Используется при десериализации дерева
+#include <queue> // Предоставляет контейнеры std::queue (очередь) и std::priority_queue
+#include <istream> // Потоковая десериализация
+#include <ostream> // Потоковая сериализация
 #include <stack>  // Для использования std::stack
 #include <memory> // Для std::unique_ptr (если будете использовать)
 
@@ -37,29 +48,131 @@ enum class TraversalType {
     // Альтернативный вариант POST_ORDER
 };
 
+// Политика балансировки дерева
+// Выбирается при создании дерева (как и TraversalType - значением перечисления, а не отдельным классом)
+enum class BalancePolicy {
+    NONE, // Обычное несбалансированное BST (на отсортированных данных вырождается в список)
+    AVL   // AVL-дерево: после Insert/Remove высоты поддеревьев отличаются не более чем на 1
+};
+
 
-template <typename T>
+// Compare - порядок значений ("меньше", см. tree_compare.h; для complex<double> - лексикографический)
+// Allocator - стандартный аллокатор, из которого пул получает блоки памяти под узлы
+template <typename T, typename Compare = TreeLess<T>, typename Allocator = std::allocator<T>>
 class BinaryTree {
 private:
     // Корень
     Node<T>* root;
+    // Пул, из которого выделяются все узлы дерева
+    NodePool<T, Allocator> pool;
+    // Количество узлов (поддерживается всеми изменяющими операциями)
+    size_t nodeCount;
+    // Политика балансировки
+    BalancePolicy balance;
+    // Хранятся ли в узлах актуальные размеры поддеревьев (для Rank/Select)
+    bool orderStatistics;
+    // Порядок значений
+    Compare compare;
+    // Путь (указатели на ссылки от корня) последней вставки/удаления
+    // Хранится в дереве, чтобы не выделять память на каждую операцию
+    std::vector<Node<T>**> path;
+#ifdef BINARY_TREE_STATS
+    // Счётчики операций (см. tree_stats.h); изменяются и константными методами поиска
+    mutable TreeStatsRecorder stats;
+#endif
 
     // Вспомогательные методы
 
     // Метод полной очистки дерева
     void Clear(Node<T>* node);
-    // Внутренний (приватный) метод глубокого копирования поддерева
-    Node<T>* Copy(Node<T>* node) const;
-    // Рекурсивный поиск узла с указанным значением в поддереве
+    // Внутренний (приватный) метод глубокого копирования поддерева (узлы выделяются из пула этого дерева)
+    Node<T>* Copy(Node<T>* node);
+    // Итеративный поиск узла с указанным значением в поддереве (nullptr - не найден)
+    // Чередующиеся спуски для пакетного поиска: store(i, узел или nullptr) для каждого keys[i]
+    template <typename Store>
+    void DescendBatch(const T* keys, size_t count, bool sortForLocality, Store store) const;
     Node<T>* FindNode(Node<T>* node, const T& value) const;
-    // Рекурсивное удаление узла с указанным значением
-    Node<T>* RemoveNode(Node<T>* node, const T& value);
+
+    // Спуски по ключу (определены в заголовке: для прозрачного Compare тип ключа известен только
+    // в месте вызова). Одно трёхстороннее сравнение KeyOrder на уровень
+
+    // Поиск с вызовом visit() на каждом пройденном узле (для статистики)
+    template <typename Key, typename Visit>
+    Node<T>* FindNode(Node<T>* node, const Key& key, Visit&& visit) const;
+    // Поиск от корня с учётом статистики (TryContains, Find)
+    template <typename Key>
+    Node<T>* LookupNode(const Key& key) const noexcept;
+    // Спуск Contains: промах и пустое дерево - TreeException
+    template <typename Key>
+    bool ContainsKey(const Key& key) const;
+    // Итеративное удаление узла с указанным ключом (false - значение не найдено)
+    template <typename Key>
+    bool RemoveNode(const Key& key);
+    // Количество значений, строго меньших key
+    template <typename Key>
+    size_t RankOf(const Key& key) const;
+    // Количество значений в [lo, hi)
+    template <typename Key>
+    size_t CountRangeOf(const Key& lo, const Key& hi) const;
+    // Значения из [lo, hi) по возрастанию
+    template <typename Key, typename Action>
+    void VisitRange(const Key& lo, const Key& hi, Action& action) const;
+    // Итератор на первое значение >= key (strict: > key)
+    template <typename Key>
+    TreeIterator<T> Bound(const Key& key, bool strict) const;
+    // Общая часть Insert(const T&) и Insert(T&&): значение копируется/перемещается только при создании узла
+    template <typename Value>
+    void InsertValue(Value&& value);
     // Поиск узла с минимальным значением в поддереве
     Node<T>* FindMin(Node<T>* node) const;
     // Функция сравнения дереьвев (сугубо вспомогательная)
     bool CompareSubtrees(Node<T>* ourNode, Node<T>* subNode) const;
 
 
+    // Балансировка
+
+    // Нужно ли запоминать путь при вставке/удалении
+    bool TracksPath() const;
+    // Высота поддерева (nullptr = 0)
+    static int NodeHeight(Node<T>* node);
+    // Размер поддерева (nullptr = 0)
+    static size_t NodeSize(Node<T>* node);
+    // Пересчёт высоты и размера поддерева узла по его потомкам
+    static void UpdateNode(Node<T>* node);
+    // Малый левый поворот, возвращает новый корень поддерева
+    static Node<T>* RotateLeft(Node<T>* node);
+    // Малый правый поворот, возвращает новый корень поддерева
+    static Node<T>* RotateRight(Node<T>* node);
+    // Восстановление AVL-инварианта в узле, возвращает новый корень поддерева
+    static Node<T>* RebalanceNode(Node<T>* node);
+    // Обновление (и балансировка) всех узлов сохранённого пути снизу вверх
+    void FixPath();
+    // Пересчёт высот и размеров всех узлов поддерева (после десериализации)
+    void RefreshMetadata(Node<T>* node);
+
+    // Создание/уничтожение узла в пуле с учётом nodeCount (значение копируется или перемещается в узел)
+    template <typename Value>
+    Node<T>* CreateNode(Value&& value);
+    void DestroyNode(Node<T>* node);
+
+    // Построение дерева из отсортированных данных
+
+    // Все значения по возрастанию
+    std::vector<T> ToSortedVector() const;
+    // Идеально сбалансированное поддерево из count отсортированных уникальных значений
+    // Значения перемещаются в узлы
+    Node<T>* BuildBalanced(T* values, size_t count);
+    // Замена содержимого сбалансированным деревом из отсортированных уникальных значений (значения перемещаются из вектора)
+    void AssignSorted(std::vector<T>&& values);
+    // Параллельная обработка значений по поддеревьям (для parallelMap/parallelWhere)
+    // process(value, out) дописывает результаты для value в out; куски возвращаются в симметричном порядке,
+    // sortPieces - каждый кусок дополнительно сортируется в своей задаче
+    template <typename Process>
+    std::vector<std::vector<T>> ProcessParallel(WorkStealingPool& workers, bool sortPieces, Process process) const;
+    // Пустое дерево с теми же настройками
+    BinaryTree EmptyLike() const;
+
+
     // Методы обходов
 
     // Приватный метод обхода поддерева
@@ -76,49 +189,76 @@ private:
     void PostOrder(Node<T>* node, std::function<void(T)> action) const;
     // Обратный обратный обход (Право → Лево → Корень)
     void ReversePostOrder(Node<T>* node, std::function<void(T)> action) const;
+    // Обход поддерева на явном стеке (без рекурсии), порядок задан на этапе компиляции
+    // VisitNulls - вызывать onNull для каждого отсутствующего потомка (нужно сериализации)
+    template <TraversalType Type, bool VisitNulls, typename OnNode, typename OnNull>
+    static void WalkSubtree(Node<T>* node, OnNode& onNode, OnNull& onNull);
+    // Обход поддерева с произвольным вызываемым объектом
+    template <TraversalType Type, typename Action>
+    static void VisitSubtree(Node<T>* node, Action& action);
 
 
     // Методы для сериализации
+
+    // Добавление значения узла и разделителя в строку
+    static void AppendToken(const T& value, TokenWriter& result);
     /* Сериализация - это процесс преобразования структуры данных 
     (в нашем случае бинарного дерева) в последовательность байт (строку), 
     которую можно сохранить в файл или передать по сети. */
 
     // Сериализация в прямом порядке (Преобразует дерево в строку в порядке "Корень → Левое поддерево → Правое поддерево")
-    void SerializePreOrder(Node<T>* node, std::string& result) const;
+    void SerializePreOrder(Node<T>* node, TokenWriter& result) const;
     // Сериализация в обратном прямом порядке (Преобразует дерево в строку в порядке "Корень → Правое поддерево → Левое поддерево")
-    void SerializeReversePreOrder(Node<T>* node, std::string& result) const;
+    void SerializeReversePreOrder(Node<T>* node, TokenWriter& result) const;
     // Сериализация в симметричном порядке (Преобразует дерево в строку в порядке "Левое поддерево → Корень → Правое поддерево")
-    void SerializeInOrder(Node<T>* node, std::string& result) const;
+    void SerializeInOrder(Node<T>* node, TokenWriter& result) const;
     //  Сериализация в обратном симметричном порядке (Преобразует дерево в строку в порядке "Правое поддерево → Корень → Левое поддерево")
-    void SerializeReverseInOrder(Node<T>* node, std::string& result) const;
+    void SerializeReverseInOrder(Node<T>* node, TokenWriter& result) const;
     // Сериализация в обратном порядке (Преобразует дерево в строку в порядке "Левое поддерево → Правое поддерево → Корень")
-    void SerializePostOrder(Node<T>* node, std::string& result) const;
+    void SerializePostOrder(Node<T>* node, TokenWriter& result) const;
     // Сериализация в обратном обратном порядке (Преобразует дерево в строку в порядке "Правое поддерево → Левое поддерево → Корень")
-    void SerializeReversePostOrder(Node<T>* node, std::string& result) const;
+    void SerializeReversePostOrder(Node<T>* node, TokenWriter& result) const;
+
+    // Запись всего дерева в выбранном порядке
+    void SerializeText(TokenWriter& result, TraversalType type) const;
 
     // Методы для десериализации
     /*Десериализация - обратный процесс восстановления 
     структуры данных из последовательности байт.*/
 
+    // Токены ("значение" или "null") читаются из потока по одному, без промежуточной очереди
     // Десериализация дерева из PreOrder представления
-    Node<T>* DeserializePreOrder(std::queue<std::string>& elements);
-    Node<T>* DeserializeReversePreOrder(std::queue<std::string>& elements);
-    Node<T>* DeserializeInOrder(std::queue<std::string>& elements);
-    Node<T>* DeserializeReverseInOrder(std::queue<std::string>& elements);
+    Node<T>* DeserializePreOrder(std::istream& input);
+    Node<T>* DeserializeReversePreOrder(std::istream& input);
+    Node<T>* DeserializeInOrder(std::istream& input);
+    Node<T>* DeserializeReverseInOrder(std::istream& input);
     // Десериализация дерева из PostOrder представления
-    Node<T>* DeserializePostOrder(std::queue<std::string>& elements);
-    Node<T>* DeserializeReversePostOrder(std::queue<std::string>& elements);
+    Node<T>* DeserializePostOrder(std::istream& input);
+    Node<T>* DeserializeReversePostOrder(std::istream& input);
+
+    // Двоичный формат (описан в binary_format.h)
+    // Запись заголовка и узлов в прямом порядке в приёмник байтов
+    template <typename Sink>
+    void WriteBinary(Sink& sink) const;
+    // Чтение дерева из источника байтов (текущее содержимое заменяется)
+    template <typename Source>
+    void ReadBinary(Source& source);
 
 
 public:
 
+    // Итераторы симметричного обхода (значения неизменяемы, поэтому iterator = const_iterator)
+    using value_type = T;
+    using size_type = size_t;
+    using const_iterator = TreeIterator<T>;
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+
     // Количество узлов в бинарном дереве
+    // Счётчик поддерживается при каждой вставке/удалении, поэтому O(1)
     size_t Size() const {
-        size_t count = 0; // Счетчик
-        // Вызов обхода дерева
-        // Для каждого узла вызывается лямбда функция и увеличивает счетчик
-        Traverse(TraversalType::IN_ORDER, [&count](const T&){ ++count; });
-        return count;
+        return nodeCount;
     }
 
 
@@ -128,6 +268,10 @@ public:
     BinaryTree();
     // Конструктор с параметром 
     explicit BinaryTree(const T& rootValue);
+    // Конструктор с политикой балансировки и аллокатором
+    explicit BinaryTree(BalancePolicy policy, const Allocator& allocator = Allocator());
+    // Конструктор с политикой балансировки, компаратором (объект с состоянием) и аллокатором
+    BinaryTree(BalancePolicy policy, const Compare& comparator, const Allocator& allocator = Allocator());
     // Конструктор копирования
     BinaryTree(const BinaryTree& other);
     // Конструктор перемещения 
@@ -136,6 +280,22 @@ public:
     ~BinaryTree();
 
 
+    // Массовая загрузка
+
+    // Сбалансированное дерево из отсортированного диапазона за O(n), узлы - одним блоком пула
+    // Повторяющиеся соседние значения попадают в дерево один раз; неотсортированный вход - InvalidTreeOperation
+    // Порядок входа проверяется тем же comparator, что получает построенное дерево
+    template <typename InputIt>
+    static BinaryTree FromSorted(InputIt first, InputIt last, BalancePolicy policy = BalancePolicy::NONE,
+                                 const Compare& comparator = Compare(), const Allocator& allocator = Allocator());
+    // Сбалансированное дерево из произвольного диапазона: сортировка (при parallel - в нескольких потоках),
+    // удаление дубликатов и загрузка как в FromSorted
+    template <typename InputIt>
+    static BinaryTree FromRange(InputIt first, InputIt last, bool parallel = false,
+                                BalancePolicy policy = BalancePolicy::NONE,
+                                const Compare& comparator = Compare(), const Allocator& allocator = Allocator());
+
+
     // Операторы присваивания
 
     // Оператор присваивания копированием
@@ -148,39 +308,216 @@ public:
 
     // Вставка значения - добавление нового узла с указанным значением в дерево
     void Insert(const T& value);
-    // Метод проверки существования значения
+    // Вставка с перемещением значения в узел (для строк и других типов с дорогим копированием)
+    // Если значение уже есть в дереве, аргумент не изменяется
+    void Insert(T&& value);
+    // Вставка значения, построенного из args (один конструктор T и одно перемещение в узел)
+    template <typename... Args>
+    void Emplace(Args&&... args) {
+        Insert(T(std::forward<Args>(args)...));
+    }
+    // Метод проверки существования значения (промах и пустое дерево - TreeException)
     bool Contains(const T& value) const;
+    // Проверка существования без исключений (промах - false)
+    bool TryContains(const T& value) const noexcept;
+    // Указатель на хранимое значение или nullptr (действителен до изменения дерева)
+    const T* Find(const T& value) const noexcept;
+    // Пакетный поиск count ключей: results[i] - есть ли keys[i] в дереве
+    // Спуски чередуются (до BATCH_LANES одновременно) с предвыборкой следующего узла, поэтому
+    // задержки памяти разных ключей перекрываются. sortForLocality - обработка ключей
+    // по возрастанию: соседние запросы идут по общим путям и попадают в кэш
+    void ContainsBatch(const T* keys, size_t count, bool* results, bool sortForLocality = false) const;
+    // То же с указателями на хранимые значения (nullptr - нет в дереве)
+    void FindBatch(const T* keys, size_t count, const T** results, bool sortForLocality = false) const;
+    // Количество одновременных спусков в пакетном поиске
+    static constexpr size_t BATCH_LANES = 16;
     // Удаление значения (с сохранением структуры дерева)
     void Remove(const T& value);
+
+    // Поиск и удаление по ключу другого типа - только для прозрачного Compare
+    // (например, std::string_view или const char* в дереве строк без создания временной строки)
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    bool Contains(const Key& key) const {
+        return ContainsKey(key);
+    }
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    bool TryContains(const Key& key) const noexcept {
+        return LookupNode(key) != nullptr;
+    }
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    const T* Find(const Key& key) const noexcept {
+        Node<T>* node = LookupNode(key);
+        return node ? &node->data : nullptr;
+    }
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    void Remove(const Key& key) {
+        if (!RemoveNode(key)) {
+            throw TreeException("Cannot remove - value not found in tree");
+        }
+    }
+
     // Проверка пустоты
     bool IsEmpty() const;
     void Clear();
+    // Текущая политика балансировки
+    BalancePolicy GetBalancePolicy() const;
+    // Высота дерева (пустое = 0, один узел = 1)
+    size_t Height() const;
+    // Копия аллокатора дерева
+    Allocator GetAllocator() const;
+    // Копия компаратора дерева
+    Compare GetCompare() const;
+
+
+    // Статистика (tree_stats.h)
+
+    // Снимок: размер, высота (для NONE - обход O(n)), блоки пула и, при сборке с BINARY_TREE_STATS,
+    // счётчики и гистограммы задержек Insert/Contains/Remove с момента создания или ResetStats()
+    TreeStats Stats() const;
+    // Обнуление счётчиков (без BINARY_TREE_STATS ничего не делает)
+    void ResetStats();
+    // Форма дерева за один итеративный обход O(n): высота, глубины листьев, гистограммы глубин
+    // и показателей баланса, узлы с одним потомком, оценка кэш-линий на поиск
+    TreeShape Analyze() const;
+    // Перестроение в дерево минимальной высоты (алгоритм Дэя-Стаута-Уоррена): O(n) времени,
+    // O(1) дополнительной памяти, узлы не перевыделяются. Для вырожденных после Insert деревьев
+    void Rebalance();
+
+
+    // Порядковые статистики
+
+    // Включение хранения размеров поддеревьев в узлах (O(n) один раз)
+    void EnableOrderStatistics();
+    bool HasOrderStatistics() const;
+    // Количество значений, строго меньших value (O(log n) для AVL с порядковыми статистиками)
+    size_t Rank(const T& value) const;
+    // k-е по возрастанию значение, k с нуля (NodeNotFound, если k >= Size())
+    T Select(size_t k) const;
+
+    // Итерирование в отсортированном порядке
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    // Поиск границ за O(высоты): первое значение >= value, первое значение > value
+    const_iterator lower_bound(const T& value) const;
+    const_iterator upper_bound(const T& value) const;
+    // Диапазон значений, равных value (пустой или из одного элемента)
+    std::pair<const_iterator, const_iterator> equal_range(const T& value) const;
+    // То же по ключу другого типа (прозрачный Compare)
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const Key& key) const {
+        return Bound(key, false);
+    }
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const Key& key) const {
+        return Bound(key, true);
+    }
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        const_iterator first = Bound(key, false);
+        const_iterator last = first;
+        if (last != end() && !compare(key, *last)) {
+            ++last;
+        }
+        return {first, last};
+    }
+
+
+    // Диапазонные запросы по полуинтервалу [lo, hi)
+
+    // Вызов action(const T&) для значений из [lo, hi) по возрастанию
+    // Поддеревья вне границ не посещаются: O(высоты + количества найденных)
+    template <typename Action>
+    void ForEachInRange(const T& lo, const T& hi, Action&& action) const {
+        VisitRange(lo, hi, action);
+    }
+    // Количество значений в [lo, hi): O(log n) для AVL с порядковыми статистиками
+    size_t CountRange(const T& lo, const T& hi) const;
+    // То же с границами другого типа (прозрачный Compare)
+    template <typename Key, typename Action, typename C = Compare, typename = typename C::is_transparent>
+    void ForEachInRange(const Key& lo, const Key& hi, Action&& action) const {
+        VisitRange(lo, hi, action);
+    }
+    template <typename Key, typename C = Compare, typename = typename C::is_transparent>
+    size_t CountRange(const Key& lo, const Key& hi) const {
+        return CountRangeOf(lo, hi);
+    }
+    // Удаление всех значений из [lo, hi), возвращает количество удалённых
+    size_t RemoveRange(const T& lo, const T& hi);
 
     // Обход дерева
     void Traverse(TraversalType type, std::function<void(T)> action) const;
+    // Обход без std::function: action(const T&) встраивается, значения не копируются
+    // Порядок обхода - параметр шаблона, например ForEach<TraversalType::IN_ORDER>(action)
+    template <TraversalType Type, typename Action>
+    void ForEach(Action&& action) const;
+    // То же с порядком, выбираемым во время выполнения (один switch на весь обход)
+    template <typename Action>
+    void ForEach(TraversalType type, Action&& action) const;
 
 
     // Функциональные операции
 
     // Трансформация значений (применение функции-маппера к каждому элементу исходного дерева)
-    BinaryTree<T> map(std::function<T(T)> mapper) const;
+    BinaryTree map(std::function<T(T)> mapper) const;
     // Фильтрация элементов (Создание нового дерева, включающего только те элементы, которые удовлетворяют условию)
-    BinaryTree<T> where(std::function<bool(T)> predicate) const;
-    // Cлияние деревьев (создание нового)
-    BinaryTree<T> merge(const BinaryTree<T>& other) const;
+    BinaryTree where(std::function<bool(T)> predicate) const;
+    // Параллельные map/where: дерево делится на задачи по поддеревьям (пул с перехватом задач),
+    // каждая задача отдаёт отсортированный кусок, результат строится сразу сбалансированным.
+    // threads - число потоков (0 - по числу ядер); функции вызываются из разных потоков одновременно
+    BinaryTree parallelMap(std::function<T(T)> mapper, unsigned threads = 0) const;
+    BinaryTree parallelWhere(std::function<bool(T)> predicate, unsigned threads = 0) const;
+    // Cлияние деревьев (создание нового) за O(n + m), результат сбалансирован
+    BinaryTree merge(const BinaryTree& other) const;
+    // Теоретико-множественные операции (линейные, результат сбалансирован)
+    BinaryTree setUnion(const BinaryTree& other) const;
+    BinaryTree setIntersection(const BinaryTree& other) const;
+    BinaryTree setDifference(const BinaryTree& other) const;
 
 
     // Работа с поддеревьями
 
     // Извлечение поддерева (Создание новое дерева, которое является копией поддерева, начиная с узла с указанным значением)
-    BinaryTree<T> extractSubtree(const T& value) const;
+    BinaryTree extractSubtree(const T& value) const;
     // Проверка наличия поддерева
-    bool containsSubtree(const BinaryTree<T>& subtree) const;
+    bool containsSubtree(const BinaryTree& subtree) const;
 
 
     // Сериализация/десериализация
     std::string serialize(TraversalType type = TraversalType::PRE_ORDER) const;
     void deserialize(const std::string& data, TraversalType type = TraversalType::PRE_ORDER);
+    // Потоковые варианты: текст пишется и читается порциями фиксированного размера,
+    // поэтому дополнительная память не зависит от размера дерева
+    void serialize(std::ostream& out, TraversalType type = TraversalType::PRE_ORDER) const;
+    void deserialize(std::istream& in, TraversalType type = TraversalType::PRE_ORDER);
+    // То же для файлового дескриптора (дескриптор не закрывается).
+    // Позиция в файле после чтения - сразу за образом; из канала или сокета чтение
+    // идёт с упреждением, и байты после образа теряются
+    void serializeToFd(int fd, TraversalType type = TraversalType::PRE_ORDER) const;
+    void deserializeFromFd(int fd, TraversalType type = TraversalType::PRE_ORDER);
+
+    // Компактный версионированный двоичный формат: за один проход, без токенов и маркеров "null"
+    std::string serializeBinary() const;
+    void deserializeBinary(const std::string& data);
+    // Потоковые варианты двоичного формата (читается ровно один образ дерева)
+    void serializeBinary(std::ostream& out) const;
+    void deserializeBinary(std::istream& in);
+    // Для дескрипторов - как у текстовых вариантов: несколько образов подряд читаются только из файла
+    void serializeBinaryToFd(int fd) const;
+    void deserializeBinaryFromFd(int fd);
+
+    // Экспорт в плоский образ без указателей (порядок Эйтцингера) для MappedBinaryTree (mapped_tree.h)
+    void ExportImage(const std::string& path) const;
+    // Неизменяемый снимок в непрерывном массиве (порядок Эйтцингера с предвыборкой), см. frozen_tree.h
+    // Дерево не меняется; снимок не зависит от дальнейших изменений дерева
+    FrozenBinaryTree<T, Compare> Freeze() const;
+    // Версия с общими неизменяемыми узлами (см. persistent_tree.h): дальнейшие версии
+    // создаются копированием пути, копии и снимки - за O(1)
+    PersistentBinaryTree<T, Compare> Persist() const;
 
 
     // Поиск по пути
@@ -190,4 +527,413 @@ public:
     // Получение значения по относительному пути от узла с указанным значением
     T GetByRelativePath(const T& base, const std::vector<std::string>& path) const;
 };
+
+
+// Шаблонные обходы определены в заголовке: тип action известен только в месте вызова
+
+// Обход поддерева на явном стеке
+// Для REVERSE_* порядков первым потомком считается правый. Память стека - O(высоты) в куче
+template <typename T, typename Compare, typename Allocator>
+template <TraversalType Type, bool VisitNulls, typename OnNode, typename OnNull>
+void BinaryTree<T, Compare, Allocator>::WalkSubtree(Node<T>* node, OnNode& onNode, OnNull& onNull) {
+    constexpr bool reversed = Type == TraversalType::REVERSE_PRE_ORDER ||
+                              Type == TraversalType::REVERSE_IN_ORDER ||
+                              Type == TraversalType::REVERSE_POST_ORDER;
+    auto first = [](Node<T>* current) { return reversed ? current->right : current->left; };
+    auto second = [](Node<T>* current) { return reversed ? current->left : current->right; };
+
+    if constexpr (Type == TraversalType::PRE_ORDER || Type == TraversalType::REVERSE_PRE_ORDER) {
+        // Прямой: узел, затем второй потомок под первым на стеке
+        std::vector<Node<T>*> nodeStack{node};
+        while (!nodeStack.empty()) {
+            Node<T>* current = nodeStack.back();
+            nodeStack.pop_back();
+            if (!current) {
+                if constexpr (VisitNulls) onNull();
+                continue;
+            }
+            onNode(static_cast<const T&>(current->data));
+            if (VisitNulls || second(current)) nodeStack.push_back(second(current));
+            if (VisitNulls || first(current)) nodeStack.push_back(first(current));
+        }
+    }
+    else if constexpr (Type == TraversalType::IN_ORDER || Type == TraversalType::REVERSE_IN_ORDER) {
+        // Симметричный: спуск по первым потомкам, затем узел и переход ко второму
+        std::vector<Node<T>*> nodeStack;
+        Node<T>* current = node;
+        while (true) {
+            while (current) {
+                nodeStack.push_back(current);
+                current = first(current);
+            }
+            if constexpr (VisitNulls) onNull(); // Пустое поддерево, на котором закончился спуск
+            if (nodeStack.empty()) {
+                break;
+            }
+            current = nodeStack.back();
+            nodeStack.pop_back();
+            onNode(static_cast<const T&>(current->data));
+            current = second(current);
+        }
+    }
+    else {
+        // Обратный: кадр проходит стадии "до первого потомка", "до второго", "после второго"
+        struct Frame {
+            Node<T>* node;
+            int stage;
+        };
+        std::vector<Frame> frames;
+        auto enter = [&frames, &onNull](Node<T>* child) {
+            if (child) {
+                frames.push_back({child, 0});
+            }
+            else if constexpr (VisitNulls) {
+                onNull();
+            }
+        };
+
+        enter(node);
+        while (!frames.empty()) {
+            Node<T>* current = frames.back().node;
+            int stage = frames.back().stage++; // Ссылка на кадр не хранится: push_back может переместить вектор
+            if (stage == 0) {
+                enter(first(current));
+            }
+            else if (stage == 1) {
+                enter(second(current));
+            }
+            else {
+                onNode(static_cast<const T&>(current->data));
+                frames.pop_back();
+            }
+        }
+    }
+}
+
+// Обход поддерева с произвольным вызываемым объектом
+template <typename T, typename Compare, typename Allocator>
+template <TraversalType Type, typename Action>
+void BinaryTree<T, Compare, Allocator>::VisitSubtree(Node<T>* node, Action& action) {
+    auto ignoreNull = []() {};
+    WalkSubtree<Type, false>(node, action, ignoreNull);
+}
+
+// Спуски по ключу
+
+// Итеративный поиск узла с ключом в поддереве
+template <typename T, typename Compare, typename Allocator>
+template <typename Key, typename Visit>
+Node<T>* BinaryTree<T, Compare, Allocator>::FindNode(Node<T>* node, const Key& key, Visit&& visit) const {
+    while (node) {
+        visit();
+        // Одно трёхстороннее сравнение определяет направление поиска
+        const int order = KeyOrder(compare, key, node->data);
+        if (order < 0) {
+            node = node->left; // Поиск в левом поддереве
+        }
+        else if (order > 0) {
+            node = node->right; // Поиск в правом поддереве
+        }
+        else {
+            return node; // Значение найдено
+        }
+    }
+    return nullptr; // Узел не найден
+}
+
+// Поиск от корня; при сборке с BINARY_TREE_STATS - с записью в статистику Contains
+template <typename T, typename Compare, typename Allocator>
+template <typename Key>
+Node<T>* BinaryTree<T, Compare, Allocator>::LookupNode(const Key& key) const noexcept {
+#ifdef BINARY_TREE_STATS
+    OperationScope scope(stats.contains);
+    Node<T>* node = FindNode(root, key, [&scope] { scope.Visit(); });
+    if (node) scope.Hit();
+    return node;
+#else
+    return FindNode(root, key, [] {});
+#endif
+}
+
+// Спуск Contains
+template <typename T, typename Compare, typename Allocator>
+template <typename Key>
+bool BinaryTree<T, Compare, Allocator>::ContainsKey(const Key& key) const {
+    // Проверка на пустоту
+    if (IsEmpty()) {
+        throw TreeException("Tree is empty - cannot check containment");
+    }
+    BINARY_TREE_STATS_ONLY(OperationScope scope(stats.contains);)
+
+    // Старт с корня
+    Node<T>* current = root;
+
+    while (current != nullptr) { // Пока есть узлы для проверки
+        BINARY_TREE_STATS_ONLY(scope.Visit();)
+        const int order = KeyOrder(compare, key, current->data);
+        if (order == 0) { // Значение найдено
+            BINARY_TREE_STATS_ONLY(scope.Hit();)
+            return true;
+        }
+        else if (order < 0) { // Движение влево
+            if (!current->left) {
+                throw TreeException("Value not found - left subtree ended");
+            }
+            current = current->left;
+        }
+        else { // Движение вправо
+            if (!current->right) {
+                throw TreeException("Value not found - right subtree ended");
+            }
+            current = current->right;
+        }
+    }
+
+    return false; // Не найдено
+}
+
+// Итеративное удаление узла с указанным ключом
+// Путь от корня запоминается, чтобы затем пересчитать высоты и сбалансировать предков
+template <typename T, typename Compare, typename Allocator>
+template <typename Key>
+bool BinaryTree<T, Compare, Allocator>::RemoveNode(const Key& key) {
+    BINARY_TREE_STATS_ONLY(OperationScope scope(stats.remove);)
+    const bool track = TracksPath();
+    path.clear();
+
+    // Поиск ссылки на удаляемый узел
+    Node<T>** link = &root;
+    while (*link) {
+        BINARY_TREE_STATS_ONLY(scope.Visit();)
+        const int order = KeyOrder(compare, key, (*link)->data);
+        if (order < 0) {
+            if (track) path.push_back(link);
+            link = &(*link)->left; // Поиск в левом поддереве
+        }
+        else if (order > 0) {
+            if (track) path.push_back(link);
+            link = &(*link)->right; // Поиск в правом поддереве
+        }
+        else {
+            break; // Найден узел для удаления
+        }
+    }
+    // Узел не найден
+    if (!*link) {
+        return false;
+    }
+
+    Node<T>* node = *link;
+    if (node->left && node->right) { // Есть оба поддерева
+        const size_t nodeIndex = path.size();
+        if (track) path.push_back(link);
+        // Поиск минимума справа
+        Node<T>** minLink = &node->right;
+        while ((*minLink)->left) {
+            if (track) path.push_back(minLink);
+            minLink = &(*minLink)->left;
+        }
+        // Узел-преемник переносится на место удаляемого целиком: значения не копируются
+        // и не перемещаются, указатели на остальные значения остаются действительными
+        Node<T>* successor = *minLink;
+        *minLink = successor->right; // У минимума нет левого потомка
+        successor->left = node->left;
+        successor->right = node->right;
+        *link = successor;
+        // Ссылка &node->right в пути теперь принадлежит преемнику
+        if (track && path.size() > nodeIndex + 1) {
+            path[nodeIndex + 1] = &successor->right;
+        }
+    }
+    else { // Не больше одного поддерева
+        *link = node->left ? node->left : node->right;
+    }
+    node->left = nullptr; // Обнуление перед удалением
+    node->right = nullptr;
+    DestroyNode(node);
+
+    FixPath();
+    BINARY_TREE_STATS_ONLY(scope.Hit();)
+    return true;
+}
+
+// Количество значений, строго меньших key
+// С размерами поддеревьев - спуск от корня за O(высоты), без них - симметричный обход
+template <typename T, typename Compare, typename Allocator>
+template <typename Key>
+size_t BinaryTree<T, Compare, Allocator>::RankOf(const Key& key) const {
+    size_t rank = 0;
+    if (!orderStatistics) {
+        ForEach<TraversalType::IN_ORDER>([this, &rank, &key](const T& current) {
+            if (compare(current, key)) ++rank;
+        });
+        return rank;
+    }
+
+    Node<T>* current = root;
+    while (current) {
+        const int order = KeyOrder(compare, key, current->data);
+        if (order < 0) {
+            current = current->left;
+        }
+        else if (order > 0) {
+            rank += NodeSize(current->left) + 1; // Левое поддерево и сам узел меньше key
+            current = current->right;
+        }
+        else {
+            rank += NodeSize(current->left);
+            break;
+        }
+    }
+    return rank;
+}
+
+// Количество значений в [lo, hi)
+// С размерами поддеревьев - разность рангов (два спуска), иначе обход только нужного диапазона
+template <typename T, typename Compare, typename Allocator>
+template <typename Key>
+size_t BinaryTree<T, Compare, Allocator>::CountRangeOf(const Key& lo, const Key& hi) const {
+    if (!compare(lo, hi)) {
+        return 0; // Пустой полуинтервал
+    }
+    if (orderStatistics) {
+        return RankOf(hi) - RankOf(lo);
+    }
+    size_t count = 0;
+    auto counter = [&count](const T&) { ++count; };
+    VisitRange(lo, hi, counter);
+    return count;
+}
+
+// Значения из [lo, hi) по возрастанию
+// Симметричный обход на явном стеке, в котором узлы меньше lo сразу уводят вправо
+// (их левые поддеревья целиком вне диапазона), а первый узел >= hi завершает обход
+template <typename T, typename Compare, typename Allocator>
+template <typename Key, typename Action>
+void BinaryTree<T, Compare, Allocator>::VisitRange(const Key& lo, const Key& hi, Action& action) const {
+    std::vector<Node<T>*> nodeStack;
+    Node<T>* current = root;
+    while (true) {
+        while (current) {
+            if (compare(current->data, lo)) {
+                current = current->right;
+            }
+            else {
+                nodeStack.push_back(current);
+                current = current->left;
+            }
+        }
+        if (nodeStack.empty()) {
+            break;
+        }
+        current = nodeStack.back();
+        nodeStack.pop_back();
+        if (!compare(current->data, hi)) {
+            break; // Дальше только значения >= hi
+        }
+        action(static_cast<const T&>(current->data));
+        current = current->right;
+    }
+}
+
+// Итератор на первое значение >= key (strict: > key)
+// Путь спуска запоминается целиком, затем обрезается до последнего узла-кандидата -
+// оставшийся префикс и есть путь от корня до найденного узла
+template <typename T, typename Compare, typename Allocator>
+template <typename Key>
+TreeIterator<T> BinaryTree<T, Compare, Allocator>::Bound(const Key& key, bool strict) const {
+    const_iterator it(root);
+    size_t candidate = 0; // Длина пути до кандидата (0 - кандидата нет)
+    Node<T>* current = root;
+    while (current) {
+        it.path.push_back(current);
+        bool fits = strict ? compare(key, current->data) : !compare(current->data, key);
+        if (fits) {
+            candidate = it.path.size(); // Подходит - ищем меньший подходящий слева
+            current = current->left;
+        }
+        else {
+            current = current->right;
+        }
+    }
+    it.path.resize(candidate);
+    return it;
+}
+
+// Сбалансированное дерево из отсортированного диапазона
+template <typename T, typename Compare, typename Allocator>
+template <typename InputIt>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::FromSorted(InputIt first, InputIt last, BalancePolicy policy,
+                                                                                const Compare& comparator, const Allocator& allocator) {
+    std::vector<T> values(first, last);
+    BinaryTree result(policy, comparator, allocator);
+    const Compare& compare = result.compare;
+    if (!std::is_sorted(values.begin(), values.end(), compare)) {
+        throw InvalidTreeOperation("FromSorted requires a sorted range");
+    }
+    // Соседние эквивалентные значения - дубликаты
+    values.erase(std::unique(values.begin(), values.end(),
+                             [&compare](const T& a, const T& b) { return KeyEquivalent(compare, a, b); }),
+                 values.end());
+
+    result.AssignSorted(std::move(values));
+    return result;
+}
+
+// Сбалансированное дерево из произвольного диапазона
+template <typename T, typename Compare, typename Allocator>
+template <typename InputIt>
+BinaryTree<T, Compare, Allocator> BinaryTree<T, Compare, Allocator>::FromRange(InputIt first, InputIt last, bool parallel, BalancePolicy policy,
+                                                                               const Compare& comparator, const Allocator& allocator) {
+    std::vector<T> values(first, last);
+    BinaryTree result(policy, comparator, allocator);
+    const Compare& compare = result.compare;
+    if (parallel) {
+        ParallelSort(values.begin(), values.end(), compare);
+    }
+    else {
+        std::sort(values.begin(), values.end(), compare);
+    }
+    values.erase(std::unique(values.begin(), values.end(),
+                             [&compare](const T& a, const T& b) { return KeyEquivalent(compare, a, b); }),
+                 values.end());
+
+    result.AssignSorted(std::move(values));
+    return result;
+}
+
+// Обход дерева с порядком, заданным параметром шаблона
+template <typename T, typename Compare, typename Allocator>
+template <TraversalType Type, typename Action>
+void BinaryTree<T, Compare, Allocator>::ForEach(Action&& action) const {
+    VisitSubtree<Type>(root, action);
+}
+
+// Обход дерева с порядком, выбираемым во время выполнения
+template <typename T, typename Compare, typename Allocator>
+template <typename Action>
+void BinaryTree<T, Compare, Allocator>::ForEach(TraversalType type, Action&& action) const {
+    switch (type) {
+        case TraversalType::PRE_ORDER:
+            ForEach<TraversalType::PRE_ORDER>(action);
+            break;
+        case TraversalType::REVERSE_PRE_ORDER:
+            ForEach<TraversalType::REVERSE_PRE_ORDER>(action);
+            break;
+        case TraversalType::IN_ORDER:
+            ForEach<TraversalType::IN_ORDER>(action);
+            break;
+        case TraversalType::REVERSE_IN_ORDER:
+            ForEach<TraversalType::REVERSE_IN_ORDER>(action);
+            break;
+        case TraversalType::POST_ORDER:
+            ForEach<TraversalType::POST_ORDER>(action);
+            break;
+        case TraversalType::REVERSE_POST_ORDER:
+            ForEach<TraversalType::REVERSE_POST_ORDER>(action);
+            break;
+        default:
+            throw TreeException("Invalid traversal type specified");
+    }
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,243 @@
+#ifndef BINARY_TREE_BLOCK_TREE_H
+#define BINARY_TREE_BLOCK_TREE_H
+
+#include "exceptions.h"
+#include "simd_search.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Дерево поиска с многоключевыми узлами (B-дерево) для арифметических ключей
+// Ключи узла занимают ровно одну кэш-линию: 16 x int/float или 8 x double.
+// Высота дерева в log2(CAPACITY + 1) раз меньше, чем у BinaryTree (примерно в 4 раза для int),
+// а поиск внутри узла - одно векторное сравнение (simd_search.h) вместо цепочки ветвлений.
+// Узлы делятся при спуске (заполненный узел делится до захода в него), поэтому вставка -
+// один проход сверху вниз без стека пути.
+// UseSimd = false - скалярный поиск в узле (для сравнения в бенчмарках)
+template <typename T, bool UseSimd = true>
+class BlockTree {
+    static_assert(std::is_arithmetic<T>::value, "BlockTree supports arithmetic keys only");
+
+public:
+    // Ключей в узле: одна кэш-линия (не меньше 4)
+    static constexpr size_t CAPACITY = 64 / sizeof(T) >= 4 ? 64 / sizeof(T) : 4;
+
+    BlockTree() : root(nullptr), count(0), height(0) {}
+
+    // Узлы принадлежат дереву: копирование запрещено, перемещение передаёт их
+    BlockTree(const BlockTree&) = delete;
+    BlockTree& operator=(const BlockTree&) = delete;
+
+    BlockTree(BlockTree&& other) noexcept : root(other.root), count(other.count), height(other.height) {
+        other.root = nullptr;
+        other.count = 0;
+        other.height = 0;
+    }
+
+    BlockTree& operator=(BlockTree&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            std::swap(root, other.root);
+            std::swap(count, other.count);
+            std::swap(height, other.height);
+        }
+        return *this;
+    }
+
+    ~BlockTree() {
+        Clear();
+    }
+
+    // Вставка значения (повторная вставка существующего значения ничего не меняет)
+    void Insert(const T& value) {
+        if (!root) {
+            root = new Block();
+            height = 1;
+        }
+        if (root->count == CAPACITY) {
+            // Корень полон - новый корень над ним, дерево растёт вверх
+            Block* top = new Block();
+            top->leaf = false;
+            top->children[0] = root;
+            root = top;
+            SplitChild(root, 0);
+            ++height;
+        }
+
+        Block* node = root;
+        while (true) {
+            size_t i = Rank(node, value);
+            if (i < node->count && node->keys[i] == value) {
+                return;
+            }
+            if (node->leaf) {
+                for (size_t j = node->count; j > i; --j) {
+                    node->keys[j] = node->keys[j - 1];
+                }
+                node->keys[i] = value;
+                ++node->count;
+                ++count;
+                return;
+            }
+            if (node->children[i]->count == CAPACITY) {
+                SplitChild(node, i);
+                // Средний ключ поднялся в node на позицию i
+                if (node->keys[i] == value) {
+                    return;
+                }
+                if (node->keys[i] < value) {
+                    ++i;
+                }
+            }
+            node = node->children[i];
+        }
+    }
+
+    // Проверка существования (промах и пустое дерево - TreeException, как в BinaryTree::Contains)
+    bool Contains(const T& value) const {
+        if (IsEmpty()) {
+            throw TreeException("Tree is empty - cannot check containment");
+        }
+        if (!TryContains(value)) {
+            throw TreeException("Value not found");
+        }
+        return true;
+    }
+
+    // Проверка существования без исключений
+    bool TryContains(const T& value) const noexcept {
+        const Block* node = root;
+        while (node) {
+            size_t i = Rank(node, value);
+            if (i < node->count && node->keys[i] == value) {
+                return true;
+            }
+            node = node->leaf ? nullptr : node->children[i];
+        }
+        return false;
+    }
+
+    size_t Size() const { return count; }
+    bool IsEmpty() const { return count == 0; }
+    // Количество уровней узлов (пустое дерево = 0)
+    size_t Height() const { return height; }
+
+    // Обход всех значений по возрастанию (явный стек: пары узел/следующий ключ)
+    template <typename Action>
+    void ForEach(Action&& action) const {
+        std::vector<std::pair<const Block*, size_t>> stack;
+        if (root) {
+            stack.push_back({root, 0});
+        }
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            const Block* node = top.first;
+            size_t i = top.second;
+            if (node->leaf) {
+                for (size_t j = 0; j < node->count; ++j) {
+                    action(node->keys[j]);
+                }
+                stack.pop_back();
+                continue;
+            }
+            // Внутренний узел: поддерево i, затем ключ i
+            if (i > node->count) {
+                stack.pop_back();
+                continue;
+            }
+            if (i > 0) {
+                action(node->keys[i - 1]);
+            }
+            ++top.second;
+            stack.push_back({node->children[i], 0});
+        }
+    }
+
+    // Удаление всех узлов (итеративно)
+    void Clear() {
+        std::vector<Block*> stack;
+        if (root) {
+            stack.push_back(root);
+        }
+        while (!stack.empty()) {
+            Block* node = stack.back();
+            stack.pop_back();
+            if (!node->leaf) {
+                for (size_t i = 0; i <= node->count; ++i) {
+                    stack.push_back(node->children[i]);
+                }
+            }
+            delete node;
+        }
+        root = nullptr;
+        count = 0;
+        height = 0;
+    }
+
+private:
+    // Значение для незанятых ячеек: не меньше любого ключа, поэтому не влияет на Rank
+    static constexpr T Padding() {
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                    : std::numeric_limits<T>::max();
+    }
+
+    // Узел: ключи - первая кэш-линия, затем указатели на детей
+    struct alignas(64) Block {
+        T keys[CAPACITY];
+        Block* children[CAPACITY + 1];
+        uint32_t count;
+        bool leaf;
+
+        Block() : children{}, count(0), leaf(true) {
+            for (T& key : keys) {
+                key = Padding();
+            }
+        }
+    };
+
+    Block* root;
+    size_t count;  // Количество значений
+    size_t height;
+
+    // Количество ключей узла, меньших value: позиция value в узле или номер поддерева для спуска
+    static size_t Rank(const Block* node, const T& value) {
+        return simd_search::CountLess<UseSimd, T, CAPACITY>(node->keys, value);
+    }
+
+    // Деление заполненного ребёнка parent->children[i] пополам, средний ключ - в parent
+    void SplitChild(Block* parent, size_t i) {
+        Block* child = parent->children[i];
+        const size_t middle = CAPACITY / 2;
+        Block* right = new Block();
+        right->leaf = child->leaf;
+        right->count = static_cast<uint32_t>(CAPACITY - middle - 1);
+        for (size_t j = 0; j < right->count; ++j) {
+            right->keys[j] = child->keys[middle + 1 + j];
+        }
+        if (!child->leaf) {
+            for (size_t j = 0; j <= right->count; ++j) {
+                right->children[j] = child->children[middle + 1 + j];
+                child->children[middle + 1 + j] = nullptr;
+            }
+        }
+        T median = child->keys[middle];
+        for (size_t j = middle; j < CAPACITY; ++j) {
+            child->keys[j] = Padding();
+        }
+        child->count = static_cast<uint32_t>(middle);
+
+        // Сдвиг ключей и детей parent вправо на одну позицию
+        for (size_t j = parent->count; j > i; --j) {
+            parent->keys[j] = parent->keys[j - 1];
+            parent->children[j + 1] = parent->children[j];
+        }
+        parent->keys[i] = median;
+        parent->children[i + 1] = right;
+        ++parent->count;
+    }
+};
+
+#endif
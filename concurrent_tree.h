@@ -0,0 +1,246 @@
+#ifndef BINARY_TREE_CONCURRENT_TREE_H
+#define BINARY_TREE_CONCURRENT_TREE_H
+
+#include "exceptions.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+// Потокобезопасное дерево поиска с блокировкой по узлам (lock coupling, "перехват рук")
+// У каждого узла свой std::shared_mutex. Спуск всегда идёт сверху вниз: блокировка ребёнка
+// берётся до снятия блокировки родителя, поэтому путь не может измениться под ногами, а
+// единый порядок захвата (родитель раньше ребёнка) исключает взаимные блокировки.
+// Читатели (Contains/TryContains/ForEach) берут разделяемые блокировки и идут параллельно
+// друг с другом и с писателями в других частях дерева; писатели (Insert/Remove) держат
+// исключительные блокировки только на двух соседних узлах пути.
+// Удалённый узел освобождается сразу: к нему можно прийти только через заблокированного
+// писателем родителя, значит, других ссылок на него нет.
+// Балансировки нет (повороты потребовали бы блокировать целые поддеревья)
+template <typename T>
+class ConcurrentBinaryTree {
+public:
+    ConcurrentBinaryTree() : root(nullptr), count(0) {}
+
+    ConcurrentBinaryTree(const ConcurrentBinaryTree&) = delete;
+    ConcurrentBinaryTree& operator=(const ConcurrentBinaryTree&) = delete;
+
+    // Уничтожение - без параллельных обращений к дереву
+    ~ConcurrentBinaryTree() {
+        std::vector<CNode*> stack;
+        if (root) {
+            stack.push_back(root);
+        }
+        while (!stack.empty()) {
+            CNode* node = stack.back();
+            stack.pop_back();
+            if (node->left) stack.push_back(node->left);
+            if (node->right) stack.push_back(node->right);
+            delete node;
+        }
+    }
+
+    // Вставка; false - значение уже было в дереве
+    bool Insert(const T& value) {
+        std::unique_lock<std::shared_mutex> rootGuard(rootLock);
+        if (!root) {
+            root = new CNode(value);
+            count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        CNode* current = root;
+        current->lock.lock();
+        rootGuard.unlock();
+
+        while (true) {
+            if (!(value < current->data) && !(current->data < value)) {
+                current->lock.unlock();
+                return false;
+            }
+            CNode*& link = value < current->data ? current->left : current->right;
+            if (!link) {
+                link = new CNode(value);
+                current->lock.unlock();
+                count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            CNode* next = link;
+            next->lock.lock();
+            current->lock.unlock();
+            current = next;
+        }
+    }
+
+    // Удаление; false - значения не было
+    bool Remove(const T& value) {
+        // Родитель текущего узла заблокирован всегда: сначала это rootLock, затем узел
+        std::shared_mutex* parentLock = &rootLock;
+        rootLock.lock();
+        CNode** link = &root; // Ссылка на текущий узел в родителе
+        CNode* current = root;
+        if (!current) {
+            rootLock.unlock();
+            return false;
+        }
+        current->lock.lock();
+
+        while (value < current->data || current->data < value) {
+            CNode** nextLink = value < current->data ? &current->left : &current->right;
+            CNode* next = *nextLink;
+            if (!next) {
+                current->lock.unlock();
+                parentLock->unlock();
+                return false;
+            }
+            next->lock.lock();
+            parentLock->unlock();
+            parentLock = &current->lock;
+            link = nextLink;
+            current = next;
+        }
+
+        if (!current->left || !current->right) {
+            // Не больше одного ребёнка - узел заменяется им в родителе
+            *link = current->left ? current->left : current->right;
+            current->lock.unlock();
+            parentLock->unlock();
+            delete current;
+        } else {
+            // Два ребёнка: значение заменяется минимумом правого поддерева, удаляется узел минимума
+            // Родитель больше не нужен - ссылка на current не меняется
+            parentLock->unlock();
+            CNode* successorParent = current;
+            CNode* successor = current->right;
+            successor->lock.lock();
+            while (successor->left) {
+                CNode* next = successor->left;
+                next->lock.lock();
+                if (successorParent != current) {
+                    successorParent->lock.unlock();
+                }
+                successorParent = successor;
+                successor = next;
+            }
+            current->data = successor->data;
+            if (successorParent == current) {
+                current->right = successor->right;
+            } else {
+                successorParent->left = successor->right;
+                successorParent->lock.unlock();
+            }
+            successor->lock.unlock();
+            current->lock.unlock();
+            delete successor;
+        }
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Проверка существования без исключений
+    bool TryContains(const T& value) const {
+        std::shared_lock<std::shared_mutex> rootGuard(rootLock);
+        CNode* current = root;
+        if (!current) {
+            return false;
+        }
+        current->lock.lock_shared();
+        rootGuard.unlock();
+
+        while (value < current->data || current->data < value) {
+            CNode* next = value < current->data ? current->left : current->right;
+            if (!next) {
+                current->lock.unlock_shared();
+                return false;
+            }
+            next->lock.lock_shared();
+            current->lock.unlock_shared();
+            current = next;
+        }
+        current->lock.unlock_shared();
+        return true;
+    }
+
+    // Проверка существования (промах и пустое дерево - TreeException, как в BinaryTree::Contains)
+    bool Contains(const T& value) const {
+        if (IsEmpty()) {
+            throw TreeException("Tree is empty - cannot check containment");
+        }
+        if (!TryContains(value)) {
+            throw TreeException("Value not found");
+        }
+        return true;
+    }
+
+    // Симметричный обход: action(const T&) по возрастанию
+    // Разделяемые блокировки держатся на узлах стека обхода (не больше высоты дерева), поэтому
+    // каждое значение присутствовало в дереве в момент посещения. Вставки и удаления в уже
+    // пройденной или ещё не достигнутой части дерева идут параллельно с обходом.
+    // action не должна изменять это же дерево (писатель будет ждать блокировку, которую держит обход)
+    template <typename Action>
+    void ForEach(Action&& action) const {
+        std::vector<CNode*> stack; // Все узлы стека заблокированы (разделяемо)
+        CNode* current;
+        {
+            std::shared_lock<std::shared_mutex> rootGuard(rootLock);
+            current = root;
+            if (current) {
+                current->lock.lock_shared();
+            }
+        }
+        try {
+            while (current || !stack.empty()) {
+                // Спуск влево с блокировкой каждого узла
+                while (current) {
+                    stack.push_back(current);
+                    current = current->left;
+                    if (current) {
+                        current->lock.lock_shared();
+                    }
+                }
+                CNode* node = stack.back();
+                action(static_cast<const T&>(node->data)); // Узел остаётся в стеке - при исключении он разблокируется
+                stack.pop_back();
+                current = node->right;
+                if (current) {
+                    current->lock.lock_shared();
+                }
+                node->lock.unlock_shared();
+            }
+        }
+        catch (...) {
+            if (current) {
+                current->lock.unlock_shared();
+            }
+            for (CNode* node : stack) {
+                node->lock.unlock_shared();
+            }
+            throw;
+        }
+    }
+
+    // Количество значений (при параллельных изменениях - моментальное значение)
+    size_t Size() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    bool IsEmpty() const {
+        return Size() == 0;
+    }
+
+private:
+    struct CNode {
+        T data;
+        CNode* left;
+        CNode* right;
+        mutable std::shared_mutex lock;
+
+        explicit CNode(const T& value) : data(value), left(nullptr), right(nullptr) {}
+    };
+
+    CNode* root;
+    mutable std::shared_mutex rootLock; // Защищает указатель root
+    std::atomic<size_t> count;
+};
+
+#endif
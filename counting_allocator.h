@@ -0,0 +1,64 @@
+#ifndef BINARY_TREE_COUNTING_ALLOCATOR_H
+#define BINARY_TREE_COUNTING_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory> // std::allocator
+
+// Счётчик памяти, общий для всех копий CountingAllocator
+struct AllocationCounter {
+    std::atomic<size_t> allocations{0}; // Число вызовов allocate
+    std::atomic<size_t> bytes{0};       // Выделено и ещё не освобождено (байт)
+};
+
+// Аллокатор с состоянием: память берётся у std::allocator, расход учитывается во внешнем счётчике.
+// Копии (в том числе перепривязанные к другому типу) пишут в тот же счётчик и равны между собой.
+// Созданный по умолчанию аллокатор ничего не считает
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+
+    CountingAllocator() noexcept : counter(nullptr) {}
+    explicit CountingAllocator(AllocationCounter& target) noexcept : counter(&target) {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept : counter(other.counter) {}
+
+    T* allocate(size_t count) {
+        T* memory = std::allocator<T>().allocate(count);
+        if (counter) {
+            counter->allocations.fetch_add(1, std::memory_order_relaxed);
+            counter->bytes.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+        }
+        return memory;
+    }
+
+    void deallocate(T* memory, size_t count) noexcept {
+        if (counter) {
+            counter->bytes.fetch_sub(count * sizeof(T), std::memory_order_relaxed);
+        }
+        std::allocator<T>().deallocate(memory, count);
+    }
+
+    AllocationCounter* Counter() const noexcept {
+        return counter;
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept {
+        return counter == other.counter;
+    }
+
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& other) const noexcept {
+        return counter != other.counter;
+    }
+
+private:
+    template <typename U>
+    friend class CountingAllocator;
+
+    AllocationCounter* counter;
+};
+
+#endif
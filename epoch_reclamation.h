@@ -0,0 +1,193 @@
+#ifndef BINARY_TREE_EPOCH_RECLAMATION_H
+#define BINARY_TREE_EPOCH_RECLAMATION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Освобождение памяти по эпохам (epoch-based reclamation) для неблокирующих структур
+// Поток, читающий разделяемые узлы, держит epoch::Guard: на время его жизни поток объявляет
+// текущую глобальную эпоху. Исключённый из структуры узел передаётся в epoch::Retire и
+// удаляется только после того, как глобальная эпоха продвинется на две ступени относительно
+// эпохи исключения. Эпоха продвигается, лишь когда все активные потоки объявили текущую,
+// значит, к этому моменту ни один поток не может держать ссылку на исключённый узел.
+// Общий домен на процесс: записи потоков переиспользуются после завершения потока,
+// вместе с ещё не освобождёнными узлами
+namespace epoch {
+
+namespace detail {
+
+struct Retired {
+    void* pointer;
+    void (*deleter)(void*);
+    uint64_t epoch;
+};
+
+// Запись потока (своя кэш-линия, чтобы объявления эпохи не мешали друг другу)
+struct alignas(64) Record {
+    // (эпоха << 1) | 1 - поток внутри Guard, 0 - вне
+    std::atomic<uint64_t> state{0};
+    std::atomic<bool> inUse{true};
+    Record* next = nullptr;
+    unsigned nesting = 0;
+    size_t sinceCollect = 0;
+    std::vector<Retired> limbo;
+};
+
+class Domain {
+public:
+    // Попытка сбора после каждых COLLECT_PERIOD исключённых узлов
+    static constexpr size_t COLLECT_PERIOD = 64;
+
+    static Domain& Global() {
+        static Domain domain;
+        return domain;
+    }
+
+    Domain(const Domain&) = delete;
+    Domain& operator=(const Domain&) = delete;
+
+    // Завершение процесса: все потоки, работавшие со структурами, уже остановлены
+    ~Domain() {
+        Record* record = records.load(std::memory_order_acquire);
+        while (record) {
+            Record* next = record->next;
+            for (const Retired& item : record->limbo) {
+                item.deleter(item.pointer);
+            }
+            delete record;
+            record = next;
+        }
+    }
+
+    void Enter(Record* record) {
+        if (record->nesting++ == 0) {
+            uint64_t current = globalEpoch.load(std::memory_order_acquire);
+            record->state.store((current << 1) | 1, std::memory_order_relaxed);
+            // Объявление должно стать видимым до первого чтения узлов
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void Leave(Record* record) {
+        if (--record->nesting == 0) {
+            record->state.store(0, std::memory_order_release);
+        }
+    }
+
+    void Retire(Record* record, void* pointer, void (*deleter)(void*)) {
+        record->limbo.push_back({pointer, deleter, globalEpoch.load(std::memory_order_acquire)});
+        if (++record->sinceCollect >= COLLECT_PERIOD) {
+            Collect(record);
+        }
+    }
+
+    // Продвижение эпохи (если возможно) и освобождение узлов, исключённых две эпохи назад
+    void Collect(Record* record) {
+        record->sinceCollect = 0;
+        TryAdvance();
+        uint64_t current = globalEpoch.load(std::memory_order_acquire);
+        auto safe = std::partition(record->limbo.begin(), record->limbo.end(),
+                                   [current](const Retired& item) { return item.epoch + 2 > current; });
+        for (auto it = safe; it != record->limbo.end(); ++it) {
+            it->deleter(it->pointer);
+        }
+        record->limbo.erase(safe, record->limbo.end());
+    }
+
+    // Запись для нового потока: свободная (от завершившегося потока) или новая
+    Record* Acquire() {
+        for (Record* record = records.load(std::memory_order_acquire); record; record = record->next) {
+            bool expected = false;
+            if (!record->inUse.load(std::memory_order_relaxed) &&
+                record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+        Record* record = new Record();
+        Record* head = records.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!records.compare_exchange_weak(head, record, std::memory_order_release,
+                                                std::memory_order_relaxed));
+        return record;
+    }
+
+    // Поток завершился: неосвобождённые узлы остаются в записи до её следующего владельца
+    void Release(Record* record) {
+        Collect(record);
+        record->inUse.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<uint64_t> globalEpoch{1};
+    std::atomic<Record*> records{nullptr}; // Список только растёт
+
+    Domain() = default;
+
+    void TryAdvance() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t current = globalEpoch.load(std::memory_order_relaxed);
+        for (Record* record = records.load(std::memory_order_acquire); record; record = record->next) {
+            // acquire: обращения читателя к узлам (до release в Leave) упорядочены до их освобождения
+            uint64_t state = record->state.load(std::memory_order_acquire);
+            if ((state & 1) && (state >> 1) != current) {
+                return; // Поток ещё работает в предыдущей эпохе
+            }
+        }
+        globalEpoch.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel);
+    }
+};
+
+// Запись текущего потока (создаётся при первом обращении, освобождается при завершении потока)
+class ThreadHandle {
+public:
+    ThreadHandle() : record(Domain::Global().Acquire()) {}
+    ~ThreadHandle() { Domain::Global().Release(record); }
+
+    Record* record;
+};
+
+inline Record* CurrentRecord() {
+    static thread_local ThreadHandle handle;
+    return handle.record;
+}
+
+} // namespace detail
+
+// Защита чтения: пока жив Guard, узлы, прочитанные из структуры, не будут освобождены
+// Вложенные Guard допустимы
+class Guard {
+public:
+    Guard() : record(detail::CurrentRecord()) {
+        detail::Domain::Global().Enter(record);
+    }
+
+    ~Guard() {
+        detail::Domain::Global().Leave(record);
+    }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+private:
+    detail::Record* record;
+};
+
+// Отложенное удаление узла, уже исключённого из структуры (delete после выхода всех читателей)
+template <typename T>
+void Retire(T* pointer) {
+    detail::Domain::Global().Retire(detail::CurrentRecord(), pointer,
+                                    [](void* raw) { delete static_cast<T*>(raw); });
+}
+
+// Принудительная попытка освобождения узлов текущего потока
+inline void Collect() {
+    detail::Domain::Global().Collect(detail::CurrentRecord());
+}
+
+} // namespace epoch
+
+#endif
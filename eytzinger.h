@@ -0,0 +1,104 @@
+#ifndef BINARY_TREE_EYTZINGER_H
+#define BINARY_TREE_EYTZINGER_H
+
+#include <cstddef>
+
+// Неявное дерево в порядке Эйтцингера (обход в ширину полного дерева)
+// Позиции 1..n, у позиции k дети 2k и 2k+1, родитель k/2. Указателей нет - структура
+// целиком задаётся массивом, а верхние уровни дерева лежат в начале массива рядом друг с другом.
+// Позиция 0 не используется и означает "нет узла" (аналог nullptr / end())
+namespace eytzinger {
+
+// Позиция минимального элемента (самый левый узел)
+inline size_t First(size_t n) {
+    if (n == 0) {
+        return 0;
+    }
+    size_t k = 1;
+    while (2 * k <= n) {
+        k *= 2;
+    }
+    return k;
+}
+
+// Позиция максимального элемента (самый правый узел)
+inline size_t Last(size_t n) {
+    if (n == 0) {
+        return 0;
+    }
+    size_t k = 1;
+    while (2 * k + 1 <= n) {
+        k = 2 * k + 1;
+    }
+    return k;
+}
+
+// Следующая по возрастанию позиция (0 - следующей нет)
+inline size_t Next(size_t k, size_t n) {
+    if (2 * k + 1 <= n) {
+        // Минимум правого поддерева
+        k = 2 * k + 1;
+        while (2 * k <= n) {
+            k *= 2;
+        }
+        return k;
+    }
+    // Подъём, пока поднимаемся из правого поддерева, и ещё один шаг
+    while (k & 1) {
+        k >>= 1;
+    }
+    return k >> 1;
+}
+
+// Предыдущая позиция (0 - предыдущей нет)
+inline size_t Prev(size_t k, size_t n) {
+    if (2 * k <= n) {
+        // Максимум левого поддерева
+        k = 2 * k;
+        while (2 * k + 1 <= n) {
+            k = 2 * k + 1;
+        }
+        return k;
+    }
+    // Подъём, пока поднимаемся из левого поддерева, и ещё один шаг
+    while (k && !(k & 1)) {
+        k >>= 1;
+    }
+    return k >> 1;
+}
+
+// Первая позиция, значение в которой не меньше искомого (0 - все значения меньше)
+// less(k) должна возвращать "значение в позиции k < искомого"
+// Спуск без ветвлений по результату сравнения: k = 2k + less(k)
+// prefetch(k) вызывается перед сравнением на каждом уровне - для предвыборки потомков
+template <typename Less, typename Prefetch>
+size_t LowerBound(size_t n, Less less, Prefetch prefetch) {
+    size_t k = 1;
+    while (k <= n) {
+        prefetch(k);
+        k = 2 * k + static_cast<size_t>(less(k));
+    }
+    // Последний поворот налево - это и есть ответ: снимаем хвост из правых поворотов
+    while (k & 1) {
+        k >>= 1;
+    }
+    return k >> 1;
+}
+
+template <typename Less>
+size_t LowerBound(size_t n, Less less) {
+    return LowerBound(n, less, [](size_t) {});
+}
+
+// Высота полного дерева из n элементов
+inline size_t Height(size_t n) {
+    size_t height = 0;
+    for (; n; n >>= 1) {
+        ++height;
+    }
+    return height;
+}
+
+} // namespace eytzinger
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef BINARY_TREE_FROZEN_TREE_H
+#define BINARY_TREE_FROZEN_TREE_H
+
+#include "eytzinger.h"
+#include "exceptions.h"
+#include "tree_compare.h"
+#include <cstddef>
+#include <iterator>
+#include <new> // std::align_val_t
+#include <utility>
+#include <vector>
+
+// Аллокатор с выравниванием блока на границу Alignment байт
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* pointer, size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// Неизменяемый снимок дерева поиска (BinaryTree::Freeze)
+// Значения лежат одним массивом в порядке Эйтцингера: у позиции k дети 2k и 2k+1.
+// Массив выровнен на кэш-линию, поэтому все потомки k через log2(B) уровней (B - значений в линии)
+// занимают одну линию [k*B, k*B + B) - её загрузка запрашивается заранее (prefetch),
+// пока идут сравнения на промежуточных уровнях. Итог - примерно один промах кэша на log2(B) уровней
+// вместо промаха на каждом уровне у узлов Node<T> с указателями.
+// Интерфейс поиска и итерирования совпадает с BinaryTree (диапазоны - полуинтервалы [lo, hi)),
+// порядок Compare - тот же, что у исходного дерева
+template <typename T, typename Compare = TreeLess<T>>
+class FrozenBinaryTree {
+public:
+    static constexpr size_t CACHE_LINE = 64;
+    // Значений в одной кэш-линии (шаг предвыборки)
+    static constexpr size_t LINE_VALUES = sizeof(T) >= CACHE_LINE ? 1 : CACHE_LINE / sizeof(T);
+
+    // Двунаправленный итератор по позициям массива (позиция 0 - end())
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() : tree(nullptr), position(0) {}
+
+        reference operator*() const { return tree->slots[position]; }
+        pointer operator->() const { return &tree->slots[position]; }
+
+        const_iterator& operator++() {
+            position = eytzinger::Next(position, tree->count);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        // --end() - максимум
+        const_iterator& operator--() {
+            position = position ? eytzinger::Prev(position, tree->count) : eytzinger::Last(tree->count);
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+
+    private:
+        friend class FrozenBinaryTree;
+
+        const FrozenBinaryTree* tree;
+        size_t position;
+
+        const_iterator(const FrozenBinaryTree* owner, size_t k) : tree(owner), position(k) {}
+    };
+
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+
+    explicit FrozenBinaryTree(const Compare& comparator = Compare()) : count(0), compare(comparator) {}
+
+    // Построение из строго возрастающей последовательности (например, BinaryTree::begin()/end())
+    // Нарушение порядка - InvalidTreeOperation
+    template <typename ForwardIt>
+    FrozenBinaryTree(ForwardIt first, ForwardIt last, const Compare& comparator = Compare())
+        : count(static_cast<size_t>(std::distance(first, last))), compare(comparator) {
+        slots.resize(count + 1); // Слот 0 не используется
+        const T* previous = nullptr;
+        for (size_t k = eytzinger::First(count); k != 0; k = eytzinger::Next(k, count), ++first) {
+            slots[k] = *first;
+            if (previous && !compare(*previous, slots[k])) {
+                throw InvalidTreeOperation("Freeze requires strictly increasing values");
+            }
+            previous = &slots[k];
+        }
+    }
+
+    size_t Size() const { return count; }
+    bool IsEmpty() const { return count == 0; }
+    // Высота полного дерева из Size() элементов
+    size_t Height() const { return eytzinger::Height(count); }
+
+    // Проверка существования (промах и пустое дерево - TreeException, как в BinaryTree::Contains)
+    bool Contains(const T& value) const {
+        if (IsEmpty()) {
+            throw TreeException("Tree is empty - cannot check containment");
+        }
+        if (!Find(value)) {
+            throw TreeException("Value not found");
+        }
+        return true;
+    }
+
+    // Проверка существования без исключений
+    bool TryContains(const T& value) const noexcept {
+        return Find(value) != nullptr;
+    }
+
+    // Указатель на хранимое значение или nullptr (действителен, пока жив снимок)
+    const T* Find(const T& value) const noexcept {
+        size_t k = LowerBound(value);
+        return (k != 0 && !compare(value, slots[k])) ? &slots[k] : nullptr;
+    }
+
+    const_iterator begin() const { return const_iterator(this, eytzinger::First(count)); }
+    const_iterator end() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    // Первое значение >= value / первое значение > value
+    const_iterator lower_bound(const T& value) const { return const_iterator(this, LowerBound(value)); }
+    const_iterator upper_bound(const T& value) const {
+        size_t k = LowerBound(value);
+        if (k != 0 && !compare(value, slots[k])) {
+            k = eytzinger::Next(k, count);
+        }
+        return const_iterator(this, k);
+    }
+    std::pair<const_iterator, const_iterator> equal_range(const T& value) const {
+        return {lower_bound(value), upper_bound(value)};
+    }
+
+    // Вызов action(const T&) для значений из [lo, hi) по возрастанию
+    template <typename Action>
+    void ForEachInRange(const T& lo, const T& hi, Action&& action) const {
+        if (!compare(lo, hi)) {
+            return;
+        }
+        for (size_t k = LowerBound(lo); k != 0 && compare(slots[k], hi); k = eytzinger::Next(k, count)) {
+            action(slots[k]);
+        }
+    }
+
+    size_t CountRange(const T& lo, const T& hi) const {
+        size_t result = 0;
+        ForEachInRange(lo, hi, [&result](const T&) { ++result; });
+        return result;
+    }
+
+    // Обход всех значений по возрастанию
+    template <typename Action>
+    void ForEach(Action&& action) const {
+        for (size_t k = eytzinger::First(count); k != 0; k = eytzinger::Next(k, count)) {
+            action(slots[k]);
+        }
+    }
+
+private:
+    std::vector<T, AlignedAllocator<T, CACHE_LINE>> slots;
+    size_t count;
+    Compare compare;
+
+    size_t LowerBound(const T& value) const {
+        const T* base = slots.data();
+        const size_t n = count;
+        return eytzinger::LowerBound(
+            n, [this, base, &value](size_t k) { return compare(base[k], value); },
+            [base, n](size_t k) {
+#if defined(__GNUC__) || defined(__clang__)
+                // Линия с потомками k через log2(LINE_VALUES) уровней
+                size_t ahead = k * LINE_VALUES;
+                if (ahead <= n) {
+                    __builtin_prefetch(base + ahead);
+                }
+#else
+                (void)base;
+                (void)n;
+                (void)k;
+#endif
+            });
+    }
+};
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef BINARY_TREE_LOCKFREE_TREE_H
+#define BINARY_TREE_LOCKFREE_TREE_H
+
+#include "epoch_reclamation.h"
+#include "exceptions.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Неблокирующее дерево поиска (Natarajan, Mittal, "Fast Concurrent Lock-Free Binary Search Trees", 2014)
+// Внешнее дерево: значения хранятся только в листьях, внутренние узлы - маршрутные (у каждого два ребёнка).
+// Каждое ребро - атомарный указатель с двумя битами в младших разрядах:
+//   FLAG - лист на конце ребра удаляется (точка линеаризации удаления),
+//   TAG  - ребро заморожено: его родитель будет исключён вместе с удаляемым соседом.
+// Помеченные рёбра больше не меняются. Удаление: пометка ребра листа (FLAG), заморозка ребра соседа (TAG),
+// затем одна CAS в ближайшем незамороженном предке заменяет всю цепочку узлов соседним поддеревом.
+// Операция, наткнувшаяся на чужое незавершённое удаление, помогает его завершить, поэтому
+// остановка любого потока не блокирует остальные.
+// Исключённые узлы освобождаются через epoch::Retire (epoch_reclamation.h): все операции идут под epoch::Guard.
+// Ключи - арифметические (int, double); NaN не поддерживается. Балансировки нет
+template <typename T>
+class LockFreeBinaryTree {
+    static_assert(std::is_arithmetic<T>::value, "LockFreeBinaryTree supports arithmetic keys only");
+
+public:
+    LockFreeBinaryTree() : count(0) {
+        // Часовые: ключи ∞0 < ∞1 < ∞2 больше любого значения, поэтому у корня и его левого ребёнка
+        // всегда есть два ребёнка, а любое значение уходит в левое поддерево S
+        root = new LNode(T(), 3); // ∞2
+        LNode* s = new LNode(T(), 2);
+        s->left.store(Pack(new LNode(T(), 1)), std::memory_order_relaxed);
+        s->right.store(Pack(new LNode(T(), 2)), std::memory_order_relaxed);
+        root->left.store(Pack(s), std::memory_order_relaxed);
+        root->right.store(Pack(new LNode(T(), 3)), std::memory_order_relaxed);
+    }
+
+    LockFreeBinaryTree(const LockFreeBinaryTree&) = delete;
+    LockFreeBinaryTree& operator=(const LockFreeBinaryTree&) = delete;
+
+    // Уничтожение - без параллельных обращений к дереву (исключённые узлы уже переданы epoch::Retire)
+    ~LockFreeBinaryTree() {
+        std::vector<LNode*> stack{root};
+        while (!stack.empty()) {
+            LNode* node = stack.back();
+            stack.pop_back();
+            if (LNode* left = Address(node->left.load(std::memory_order_relaxed))) {
+                stack.push_back(left);
+                stack.push_back(Address(node->right.load(std::memory_order_relaxed)));
+            }
+            delete node;
+        }
+    }
+
+    // Вставка; false - значение уже было в дереве
+    bool Insert(const T& value) {
+        epoch::Guard guard;
+        SeekRecord record;
+        LNode* newLeaf = new LNode(value, 0);
+        LNode* newInternal = new LNode(value, 0);
+        while (true) {
+            Seek(value, record);
+            LNode* leaf = record.leaf;
+            if (IsKey(leaf, value)) {
+                delete newLeaf;
+                delete newInternal;
+                return false;
+            }
+            // Маршрутный узел: ключ - большее из двух значений, меньшее уходит влево
+            LNode* parent = record.parent;
+            std::atomic<uintptr_t>& child = Less(value, parent) ? parent->left : parent->right;
+            if (Less(value, leaf)) {
+                newInternal->key = leaf->key;
+                newInternal->rank = leaf->rank;
+                newInternal->left.store(Pack(newLeaf), std::memory_order_relaxed);
+                newInternal->right.store(Pack(leaf), std::memory_order_relaxed);
+            } else {
+                newInternal->key = value;
+                newInternal->rank = 0;
+                newInternal->left.store(Pack(leaf), std::memory_order_relaxed);
+                newInternal->right.store(Pack(newLeaf), std::memory_order_relaxed);
+            }
+            uintptr_t expected = Pack(leaf);
+            if (child.compare_exchange_strong(expected, Pack(newInternal), std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            // Ребро занято чужим удалением этого же листа - помощь и повтор
+            if (Address(expected) == leaf && (expected & (FLAG | TAG))) {
+                Cleanup(value, record);
+            }
+        }
+    }
+
+    // Удаление; false - значения не было
+    bool Remove(const T& value) {
+        epoch::Guard guard;
+        SeekRecord record;
+        LNode* target = nullptr; // Помеченный нами лист (после успешной пометки)
+        while (true) {
+            Seek(value, record);
+            if (!target) {
+                LNode* leaf = record.leaf;
+                if (!IsKey(leaf, value)) {
+                    return false;
+                }
+                LNode* parent = record.parent;
+                std::atomic<uintptr_t>& child = Less(value, parent) ? parent->left : parent->right;
+                uintptr_t expected = Pack(leaf);
+                if (child.compare_exchange_strong(expected, expected | FLAG, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+                    count.fetch_sub(1, std::memory_order_relaxed);
+                    target = leaf;
+                    if (Cleanup(value, record)) {
+                        return true;
+                    }
+                } else if (Address(expected) == leaf && (expected & (FLAG | TAG))) {
+                    Cleanup(value, record);
+                }
+            } else {
+                // Лист уже помечен: остаётся исключить его (если другой поток ещё не сделал этого)
+                if (record.leaf != target || Cleanup(value, record)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    // Проверка существования без исключений (спуск без записи и без помощи)
+    bool TryContains(const T& value) const {
+        epoch::Guard guard;
+        const LNode* node = root;
+        while (uintptr_t left = node->left.load(std::memory_order_acquire)) {
+            node = Address(Less(value, node) ? left : node->right.load(std::memory_order_acquire));
+        }
+        return IsKey(node, value);
+    }
+
+    // Проверка существования (промах и пустое дерево - TreeException, как в BinaryTree::Contains)
+    bool Contains(const T& value) const {
+        if (IsEmpty()) {
+            throw TreeException("Tree is empty - cannot check containment");
+        }
+        if (!TryContains(value)) {
+            throw TreeException("Value not found");
+        }
+        return true;
+    }
+
+    // Обход по возрастанию: action(const T&)
+    // Без параллельных изменений - точное содержимое; при изменениях - значения, бывшие в дереве
+    // во время обхода (помеченные к удалению пропускаются, порядок строго возрастающий)
+    template <typename Action>
+    void ForEach(Action&& action) const {
+        epoch::Guard guard;
+        std::vector<const LNode*> stack{root};
+        bool emitted = false;
+        T last = T();
+        while (!stack.empty()) {
+            const LNode* node = stack.back();
+            stack.pop_back();
+            uintptr_t left = node->left.load(std::memory_order_acquire);
+            if (left) {
+                uintptr_t right = node->right.load(std::memory_order_acquire);
+                // Лист на помеченном ребре (FLAG) уже удалён логически
+                if (!(right & FLAG)) {
+                    stack.push_back(Address(right));
+                }
+                if (!(left & FLAG)) {
+                    stack.push_back(Address(left));
+                }
+            } else if (node->rank == 0 && (!emitted || last < node->key)) {
+                // Обход может пройти перенесённое поддерево повторно - повторы отсекаются по порядку
+                emitted = true;
+                last = node->key;
+                action(static_cast<const T&>(last));
+            }
+        }
+    }
+
+    // Количество значений (при параллельных изменениях - моментальное значение)
+    size_t Size() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    bool IsEmpty() const {
+        return Size() == 0;
+    }
+
+private:
+    static constexpr uintptr_t FLAG = 1;
+    static constexpr uintptr_t TAG = 2;
+
+    // Лист (left == 0) или маршрутный узел. rank > 0 - часовой ∞(rank - 1), key не используется
+    // Узлы выровнены не меньше чем на 4 байта - два младших бита указателя свободны под FLAG и TAG
+    struct LNode {
+        T key;
+        int rank;
+        std::atomic<uintptr_t> left;
+        std::atomic<uintptr_t> right;
+
+        LNode(const T& value, int infinity) : key(value), rank(infinity), left(0), right(0) {}
+    };
+
+    // Результат спуска: лист, его родитель и участок пути, который исключит очистка
+    // (successor - первый узел после последнего незамороженного ребра, ancestor - его родитель)
+    struct SeekRecord {
+        LNode* ancestor;
+        LNode* successor;
+        LNode* parent;
+        LNode* leaf;
+    };
+
+    LNode* root; // Часовой ∞2, его левый ребёнок - часовой ∞1 (S)
+    std::atomic<size_t> count;
+
+    static uintptr_t Pack(LNode* node) { return reinterpret_cast<uintptr_t>(node); }
+    static LNode* Address(uintptr_t edge) { return reinterpret_cast<LNode*>(edge & ~(FLAG | TAG)); }
+
+    // value < ключа узла (часовые больше любого значения)
+    static bool Less(const T& value, const LNode* node) {
+        return node->rank > 0 || value < node->key;
+    }
+
+    static bool IsKey(const LNode* leaf, const T& value) {
+        return leaf->rank == 0 && !(value < leaf->key) && !(leaf->key < value);
+    }
+
+    void Seek(const T& value, SeekRecord& record) const {
+        LNode* s = Address(root->left.load(std::memory_order_acquire));
+        record.ancestor = root;
+        record.successor = s;
+        record.parent = s;
+        uintptr_t parentEdge = s->left.load(std::memory_order_acquire);
+        record.leaf = Address(parentEdge);
+        uintptr_t currentEdge = record.leaf->left.load(std::memory_order_acquire);
+        while (LNode* current = Address(currentEdge)) {
+            // Незамороженное ребро parent -> leaf сдвигает точку будущей очистки вниз
+            if (!(parentEdge & TAG)) {
+                record.ancestor = record.parent;
+                record.successor = record.leaf;
+            }
+            record.parent = record.leaf;
+            record.leaf = current;
+            parentEdge = currentEdge;
+            currentEdge = (Less(value, current) ? current->left : current->right).load(std::memory_order_acquire);
+        }
+    }
+
+    // Исключение помеченного листа вместе с цепочкой successor..parent; true - исключил этот поток
+    bool Cleanup(const T& value, const SeekRecord& record) {
+        LNode* ancestor = record.ancestor;
+        LNode* successor = record.successor;
+        LNode* parent = record.parent;
+        std::atomic<uintptr_t>& successorEdge = Less(value, ancestor) ? ancestor->left : ancestor->right;
+        std::atomic<uintptr_t>* childEdge = Less(value, parent) ? &parent->left : &parent->right;
+        std::atomic<uintptr_t>* siblingEdge = Less(value, parent) ? &parent->right : &parent->left;
+        if (!(childEdge->load(std::memory_order_acquire) & FLAG)) {
+            // Помечен не лист value, а его сосед: остаётся поддерево на пути value
+            std::swap(childEdge, siblingEdge);
+        }
+        // Заморозка остающегося ребра, затем перенос его поддерева (с флагом) на место successor
+        uintptr_t sibling = siblingEdge->fetch_or(TAG, std::memory_order_acq_rel) & ~TAG;
+        uintptr_t expected = Pack(successor);
+        if (!successorEdge.compare_exchange_strong(expected, sibling, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+            return false;
+        }
+        RetireChain(value, successor, parent, childEdge);
+        return true;
+    }
+
+    // Освобождение исключённой цепочки: узлы successor..parent и помеченные листья на боковых рёбрах
+    // Рёбра цепочки заморожены (не меняются), поэтому её можно пройти тем же путём, что и Seek
+    void RetireChain(const T& value, LNode* node, LNode* parent, std::atomic<uintptr_t>* removedEdge) {
+        while (node != parent) {
+            bool left = Less(value, node);
+            epoch::Retire(Address((left ? node->right : node->left).load(std::memory_order_acquire)));
+            LNode* next = Address((left ? node->left : node->right).load(std::memory_order_acquire));
+            epoch::Retire(node);
+            node = next;
+        }
+        epoch::Retire(Address(removedEdge->load(std::memory_order_acquire)));
+        epoch::Retire(parent);
+    }
+};
+
+#endif
@@ -1,9 +1,24 @@
 #include "binary_tree.h"
+#include "mapped_tree.h"
+#include "block_tree.h"
+#include "concurrent_tree.h"
+#include "lockfree_tree.h"
+#include "persistent_tree.h"
+#include "counting_allocator.h"
 #include <chrono>
 #include <fstream>
+#include <memory>
 #include <random>
 #include <complex>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unistd.h>
 
 using namespace std;
 using namespace std::chrono;
@@ -80,104 +95,164 @@ void test_all_features() {
 }
 
 
-// Тестирование скорости операций
-void performance_test() {
-    ofstream out("performance.csv");
-    out << "n,insert_time,find_time,remove_time\n";
+// Регрессионный тест на вырожденном дереве-цепочке: все обходы, копирование,
+// сериализация и очистка работают без рекурсии и не переполняют стек вызовов
+void performance_test_deep_chain(int depth) {
+    cout << "Building a chain of depth " << depth << "..." << endl;
+    // Цепочка "1 null 2 null ... depth null null": у каждого узла только правый потомок
+    string chain;
+    chain.reserve(static_cast<size_t>(depth) * 14);
+    for (int i = 1; i <= depth; ++i) {
+        chain += to_string(i);
+        chain += " null ";
+    }
+    chain += "null";
 
-    // Более скромные размеры для тестирования
-    for (int n = 1000; n <= 10000; n *= 10) {
-        BinaryTree<int> tree;
-        vector<int> elements(n);
-        
-        // Генерируем уникальные значения для более реалистичного теста
-        for (int i = 0; i < n; ++i) {
-            elements[i] = i + 1;
-        }
-        
-        // Перемешиваем значения
-        random_device rd;
-        mt19937 gen(rd());
-        shuffle(elements.begin(), elements.end(), gen);
-
-        // Тест вставки
-        auto start = high_resolution_clock::now();
-        for (int i = 0; i < n; ++i) {
-            tree.Insert(elements[i]);
-        }
-        auto insert_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    auto start = high_resolution_clock::now();
+    BinaryTree<int> tree;
+    tree.deserialize(chain, TraversalType::PRE_ORDER);
+    string().swap(chain);
+    auto build_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "Deserialize: " << build_time << " ms, size " << tree.Size() << ", height " << tree.Height() << endl;
 
-        // Тест поиска - используем первые 100 элементов для поиска
+    for (TraversalType type : {TraversalType::IN_ORDER, TraversalType::POST_ORDER, TraversalType::REVERSE_PRE_ORDER}) {
+        long long sum = 0;
         start = high_resolution_clock::now();
-        for (int i = 0; i < 100; ++i) {
-            tree.Contains(elements[i]);
-        }
-        auto find_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        tree.ForEach(type, [&sum](const int& val) { sum += val; });
+        auto walk_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        cout << "Traversal " << static_cast<int>(type) << ": " << walk_time << " ms (sum " << sum << ")" << endl;
+    }
 
-        // Тест удаления - удаляем первые 100 элементов
-        start = high_resolution_clock::now();
-        for (int i = 0; i < 100; ++i) {
-            tree.Remove(elements[i]);
-        }
-        auto remove_time = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    start = high_resolution_clock::now();
+    BinaryTree<int> copy = tree;
+    auto copy_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "Copy: " << copy_time << " ms, subtree check " << (tree.containsSubtree(copy) ? "ok" : "FAILED") << endl;
+
+    start = high_resolution_clock::now();
+    size_t serialized_size = copy.serialize(TraversalType::POST_ORDER).size();
+    auto serialize_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "Serialize: " << serialize_time << " ms (" << serialized_size << " bytes)" << endl;
+
+    start = high_resolution_clock::now();
+    tree.Rebalance(); // DSW: без рекурсии и дополнительной памяти
+    auto rebalance_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "Rebalance: " << rebalance_time << " ms, height " << tree.Height() << endl;
 
-        out << n << "," << insert_time << "," << find_time << "," << remove_time << "\n";
-        cout << "Completed test for n = " << n << endl;
+    start = high_resolution_clock::now();
+    copy.Remove(1); // Удаление корня цепочки
+    copy.Remove(depth); // Удаление последнего узла - спуск через всю цепочку
+    tree.Clear();
+    copy.Clear();
+    auto clear_time = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    cout << "Remove + Clear: " << clear_time << " ms" << endl;
+}
+
+// Нагрузочный тест потокобезопасного дерева
+// Писатели работают со своими классами ключей (key % writers == id) и ведут ожидаемое множество:
+// у каждого ключа один писатель, поэтому результаты Insert/Remove обязаны совпадать с последовательным
+// исполнением. Читатели параллельно ищут и обходят дерево, проверяя порядок значений
+template <typename Key, typename Tree>
+bool concurrent_stress(Tree& tree) {
+    const int writers = 4;
+    const int readers = 2;
+    vector<set<Key>> expected(writers);
+    atomic<bool> writers_done(false);
+    atomic<bool> order_ok(true);
+    vector<thread> stress_threads;
+    for (int id = 0; id < writers; ++id) {
+        stress_threads.emplace_back([&, id]() {
+            mt19937 writer_gen(100 + id);
+            for (int op = 0; op < 30000; ++op) {
+                Key key = static_cast<Key>(static_cast<int>(writer_gen() % 2000) * writers + id);
+                if (writer_gen() % 3 == 0) {
+                    bool removed = tree.Remove(key);
+                    if (removed != (expected[id].erase(key) > 0)) {
+                        order_ok = false;
+                    }
+                } else {
+                    bool inserted = tree.Insert(key);
+                    if (inserted != expected[id].insert(key).second) {
+                        order_ok = false;
+                    }
+                }
+            }
+        });
+    }
+    for (int id = 0; id < readers; ++id) {
+        stress_threads.emplace_back([&]() {
+            while (!writers_done) {
+                Key previous = Key();
+                bool first = true;
+                tree.ForEach([&](Key value) {
+                    if (!first && value <= previous) {
+                        order_ok = false;
+                    }
+                    first = false;
+                    previous = value;
+                });
+                for (int key = 0; key < 1000; ++key) {
+                    tree.TryContains(static_cast<Key>(key));
+                }
+            }
+        });
     }
+    for (int id = 0; id < writers; ++id) {
+        stress_threads[id].join();
+    }
+    writers_done = true;
+    for (size_t i = writers; i < stress_threads.size(); ++i) {
+        stress_threads[i].join();
+    }
+    set<Key> expected_all;
+    for (const set<Key>& part : expected) {
+        expected_all.insert(part.begin(), part.end());
+    }
+    vector<Key> final_values;
+    tree.ForEach([&final_values](Key value) { final_values.push_back(value); });
+    return order_ok && tree.Size() == expected_all.size() &&
+           final_values == vector<Key>(expected_all.begin(), expected_all.end());
 }
 
-void performance_test_large() {
-    const int n = 1000000; // 10^6 элементов
-    cout << "Running performance test with " << n << " elements..." << endl;
-    
-    BinaryTree<int> tree;
-    vector<int> elements(n);
-    
-    // Заполняем последовательными числами и перемешиваем
-    iota(elements.begin(), elements.end(), 1);
-    random_device rd;
-    mt19937 gen(rd());
-    shuffle(elements.begin(), elements.end(), gen);
-    
-    // Тест вставки с прогресс-баром
-    cout << "Inserting elements...";
-    auto start = chrono::high_resolution_clock::now();
-    for (int i = 0; i < n; ++i) {
-        tree.Insert(elements[i]);
-        if (i % 100000 == 0) cout << "." << flush; // Прогресс каждые 100к элементов
-    }
-    auto insert_time = chrono::duration_cast<chrono::milliseconds>(
-        chrono::high_resolution_clock::now() - start).count();
-    cout << "\nInsert time: " << insert_time << " ms" << endl;
-    
-    // Тест поиска (первые 1000 элементов)
-    cout << "Searching elements...";
-    start = chrono::high_resolution_clock::now();
-    for (int i = 0; i < 1000; ++i) {
-        if (!tree.Contains(elements[i])) {
-            cerr << "\nError: element not found!" << endl;
-            return;
+// Все потоки меняют одни и те же ключи. Для каждого ключа успешные вставки и удаления линеаризуемой
+// структуры чередуются, начиная со вставки, поэтому их разность - 0 или 1 и равна итоговому наличию ключа
+template <typename Tree>
+bool contended_stress(Tree& tree) {
+    const int threads = 4;
+    const int keys = 64;
+    vector<atomic<int>> balance(keys);
+    for (atomic<int>& value : balance) {
+        value = 0;
+    }
+    vector<thread> stress_threads;
+    for (int id = 0; id < threads; ++id) {
+        stress_threads.emplace_back([&, id]() {
+            mt19937 gen(300 + id);
+            for (int op = 0; op < 40000; ++op) {
+                int key = static_cast<int>(gen() % keys);
+                if (gen() & 1) {
+                    if (tree.Insert(key)) {
+                        ++balance[key];
+                    }
+                } else if (tree.Remove(key)) {
+                    --balance[key];
+                }
+            }
+        });
+    }
+    for (thread& worker : stress_threads) {
+        worker.join();
+    }
+    size_t present = 0;
+    for (int key = 0; key < keys; ++key) {
+        int difference = balance[key].load();
+        if (difference != (tree.TryContains(key) ? 1 : 0)) {
+            return false;
         }
+        present += static_cast<size_t>(difference);
     }
-    auto search_time = chrono::duration_cast<chrono::milliseconds>(
-        chrono::high_resolution_clock::now() - start).count();
-    cout << "\nSearch time for 1000 elements: " << search_time << " ms" << endl;
-    
-    // Тест удаления (первые 1000 элементов)
-    cout << "Removing elements...";
-    start = chrono::high_resolution_clock::now();
-    for (int i = 0; i < 1000; ++i) {
-        tree.Remove(elements[i]);
-    }
-    auto remove_time = chrono::duration_cast<chrono::milliseconds>(
-        chrono::high_resolution_clock::now() - start).count();
-    cout << "\nRemove time for 1000 elements: " << remove_time << " ms" << endl;
-    
-    // Проверка размера
-    cout << "Final size (should be " << n-1000 << "): ";
-    // Здесь нужно добавить метод Size() в ваш класс BinaryTree
-    // cout << tree.Size() << endl;
+    return tree.Size() == present;
 }
+
 // Модульные тесты
 void unit_tests() {
     // Тест для int
@@ -216,6 +291,629 @@ void unit_tests() {
     } catch (...) {
         cout << "Complex test failed\n";
     } 
+
+    // Тест AVL: инвариант после вставок и удалений
+    BinaryTree<int> avl_tree(BalancePolicy::AVL);
+    for (int i = 1; i <= 1000; ++i) {
+        avl_tree.Insert(i);
+    }
+    for (int i = 1; i <= 1000; i += 3) {
+        avl_tree.Remove(i);
+    }
+    bool avl_ok = avl_tree.Height() <= 15 && avl_tree.Size() == 666;
+    avl_tree.Traverse(TraversalType::IN_ORDER, [&avl_ok, prev = 0](int val) mutable {
+        if (val <= prev || val % 3 == 1) avl_ok = false;
+        prev = val;
+    });
+    cout << (avl_ok ? "AVL test passed\n" : "AVL test failed\n");
+
+    // Тест порядковых статистик: Size/Rank/Select согласованы с отсортированным порядком
+    avl_tree.EnableOrderStatistics();
+    bool stats_ok = avl_tree.Size() == 666;
+    for (size_t k = 0; k < avl_tree.Size(); ++k) {
+        int value = avl_tree.Select(k);
+        if (avl_tree.Rank(value) != k) stats_ok = false;
+    }
+    avl_tree.Insert(1);
+    stats_ok = stats_ok && avl_tree.Select(0) == 1 && avl_tree.Rank(1001) == 667;
+    BinaryTree<int> copied = avl_tree;
+    copied.Clear();
+    stats_ok = stats_ok && copied.Size() == 0 && avl_tree.Size() == 667;
+    cout << (stats_ok ? "Order statistics test passed\n" : "Order statistics test failed\n");
+
+    // Тест поиска без исключений
+    BinaryTree<int> empty_tree;
+    const int* found = avl_tree.Find(500);
+    bool lookup_ok = !empty_tree.TryContains(1) && empty_tree.Find(1) == nullptr &&
+                     avl_tree.TryContains(2) && !avl_tree.TryContains(4) &&
+                     found != nullptr && *found == 500;
+    cout << (lookup_ok ? "Non-throwing lookup test passed\n" : "Non-throwing lookup test failed\n");
+
+    // Тест шаблонных обходов: порядок совпадает с Traverse для всех шести типов
+    bool foreach_ok = true;
+    for (TraversalType type : {TraversalType::PRE_ORDER, TraversalType::REVERSE_PRE_ORDER,
+                               TraversalType::IN_ORDER, TraversalType::REVERSE_IN_ORDER,
+                               TraversalType::POST_ORDER, TraversalType::REVERSE_POST_ORDER}) {
+        vector<int> expected, actual;
+        avl_tree.Traverse(type, [&expected](int val) { expected.push_back(val); });
+        avl_tree.ForEach(type, [&actual](const int& val) { actual.push_back(val); });
+        foreach_ok = foreach_ok && expected == actual;
+    }
+    cout << (foreach_ok ? "ForEach test passed\n" : "ForEach test failed\n");
+
+    // Тест сериализации: повторная сериализация восстановленного дерева даёт ту же строку
+    bool serialize_ok = true;
+    for (TraversalType type : {TraversalType::PRE_ORDER, TraversalType::REVERSE_PRE_ORDER,
+                               TraversalType::POST_ORDER, TraversalType::REVERSE_POST_ORDER}) {
+        string data = avl_tree.serialize(type);
+        BinaryTree<int> restored;
+        restored.deserialize(data, type);
+        serialize_ok = serialize_ok && restored.serialize(type) == data && restored.Size() == avl_tree.Size();
+    }
+    cout << (serialize_ok ? "Serialization round-trip test passed\n" : "Serialization round-trip test failed\n");
+
+    // Тест итераторов: прямой и обратный проход, границы и алгоритмы STL
+    vector<int> sorted_values;
+    avl_tree.Traverse(TraversalType::IN_ORDER, [&sorted_values](int val) { sorted_values.push_back(val); });
+    vector<int> forward(avl_tree.begin(), avl_tree.end());
+    vector<int> backward(avl_tree.rbegin(), avl_tree.rend());
+    reverse(backward.begin(), backward.end());
+    auto range = avl_tree.equal_range(500);
+    bool iterator_ok = forward == sorted_values && backward == sorted_values &&
+                       static_cast<size_t>(distance(avl_tree.begin(), avl_tree.end())) == avl_tree.Size() &&
+                       *avl_tree.lower_bound(4) == 5 && *avl_tree.upper_bound(5) == 6 &&
+                       avl_tree.lower_bound(1001) == avl_tree.end() &&
+                       distance(range.first, range.second) == 1 && *range.first == 500 &&
+                       *prev(avl_tree.end()) == sorted_values.back() &&
+                       find(avl_tree.begin(), avl_tree.end(), 999) != avl_tree.end();
+    cout << (iterator_ok ? "Iterator test passed\n" : "Iterator test failed\n");
+
+    // Тест диапазонных запросов: [lo, hi) совпадает с фильтрацией отсортированных значений
+    vector<int> in_range;
+    avl_tree.ForEachInRange(100, 200, [&in_range](const int& val) { in_range.push_back(val); });
+    vector<int> expected_range;
+    copy_if(sorted_values.begin(), sorted_values.end(), back_inserter(expected_range),
+            [](int val) { return val >= 100 && val < 200; });
+    BinaryTree<int> plain_tree = avl_tree;
+    bool range_ok = in_range == expected_range && avl_tree.CountRange(100, 200) == expected_range.size() &&
+                    avl_tree.CountRange(200, 100) == 0;
+    range_ok = range_ok && avl_tree.RemoveRange(100, 200) == expected_range.size() &&
+               avl_tree.CountRange(100, 200) == 0 && !avl_tree.TryContains(150) && avl_tree.TryContains(200) &&
+               avl_tree.Size() == sorted_values.size() - expected_range.size();
+    avl_tree = plain_tree; // Восстановление для следующих тестов
+    cout << (range_ok ? "Range query test passed\n" : "Range query test failed\n");
+
+    // Тест слияния и теоретико-множественных операций (с дубликатами)
+    BinaryTree<int> evens, threes;
+    for (int i = 0; i < 30; i += 2) evens.Insert(i);
+    for (int i = 0; i < 30; i += 3) threes.Insert(i);
+    BinaryTree<int> merged_tree = evens.merge(threes);
+    vector<int> united(merged_tree.begin(), merged_tree.end());
+    BinaryTree<int> both = evens.setIntersection(threes);
+    BinaryTree<int> only_evens = evens.setDifference(threes);
+    bool merge_ok = united.size() == 20 && is_sorted(united.begin(), united.end()) &&
+                    vector<int>(both.begin(), both.end()) == vector<int>{0, 6, 12, 18, 24} &&
+                    only_evens.Size() == 10 && !only_evens.TryContains(6) && only_evens.TryContains(4) &&
+                    merged_tree.Height() <= 5;
+    cout << (merge_ok ? "Merge test passed\n" : "Merge test failed\n");
+
+    // Тест массовой загрузки: дубликаты отбрасываются, высота минимальна, неотсортированный вход отклоняется
+    vector<int> bulk = {9, 3, 7, 3, 1, 5, 9, 2};
+    BinaryTree<int> bulk_tree = BinaryTree<int>::FromRange(bulk.begin(), bulk.end(), true, BalancePolicy::AVL);
+    vector<string> words = {"apple", "banana", "banana", "cherry"};
+    BinaryTree<string> word_tree = BinaryTree<string>::FromSorted(words.begin(), words.end());
+    bool bulk_ok = vector<int>(bulk_tree.begin(), bulk_tree.end()) == vector<int>{1, 2, 3, 5, 7, 9} &&
+                   bulk_tree.Height() == 3 && word_tree.Size() == 3 && word_tree.TryContains("cherry");
+    bulk_tree.Insert(4);
+    bulk_ok = bulk_ok && bulk_tree.TryContains(4);
+    try {
+        BinaryTree<int>::FromSorted(bulk.begin(), bulk.end());
+        bulk_ok = false;
+    } catch (const InvalidTreeOperation&) {
+    }
+    cout << (bulk_ok ? "Bulk load test passed\n" : "Bulk load test failed\n");
+
+    // Тест двоичного формата для всех пяти типов ключей
+    auto binary_round_trip = [](const auto& tree) {
+        using Tree = decay_t<decltype(tree)>;
+        Tree restored;
+        restored.deserializeBinary(tree.serializeBinary());
+        return restored.serialize(TraversalType::PRE_ORDER) == tree.serialize(TraversalType::PRE_ORDER) &&
+               restored.Size() == tree.Size();
+    };
+    BinaryTree<float> float_tree;
+    BinaryTree<double> double_tree;
+    for (int i : {5, -3, 8, 1, -7}) {
+        float_tree.Insert(i * 0.25f);
+        double_tree.Insert(i * 1e-3);
+    }
+    BinaryTree<int> extreme_tree;
+    for (int i : {0, numeric_limits<int>::min(), numeric_limits<int>::max(), -1, 1}) {
+        extreme_tree.Insert(i);
+    }
+    bool binary_ok = binary_round_trip(avl_tree) && binary_round_trip(extreme_tree) &&
+                     binary_round_trip(BinaryTree<int>()) && binary_round_trip(float_tree) &&
+                     binary_round_trip(double_tree) && binary_round_trip(str_tree) &&
+                     binary_round_trip(comp_tree);
+    try {
+        float_tree.deserializeBinary(avl_tree.serializeBinary()); // Чужой тип ключа
+        binary_ok = false;
+    } catch (const SerializationError&) {
+        binary_ok = binary_ok && float_tree.IsEmpty();
+    }
+    // Повреждённые заголовки: длина строки 2^30 и 2^40 узлов при нескольких байтах данных
+    // должны отвергаться без выделения памяти под заявленные размеры
+    auto varint = [](uint64_t value) {
+        string bytes;
+        for (; value >= 0x80; value >>= 7) {
+            bytes += static_cast<char>(value | 0x80);
+        }
+        return bytes + static_cast<char>(value);
+    };
+    string huge_string = string("BTRE\x01\x04", 6) + varint(1) + varint(uint64_t(1) << 32) + "ab";
+    string huge_count = string("BTRE\x01\x01", 6) + varint(uint64_t(1) << 40) + varint(0);
+    auto rejects = [](auto&& load) {
+        try {
+            load();
+            return false;
+        } catch (const SerializationError&) {
+            return true;
+        }
+    };
+    BinaryTree<string> corrupt_strings;
+    BinaryTree<int> corrupt_ints;
+    stringstream corrupt_stream(huge_string);
+    binary_ok = binary_ok && rejects([&] { corrupt_strings.deserializeBinary(huge_string); }) &&
+                rejects([&] { corrupt_strings.deserializeBinary(corrupt_stream); }) &&
+                rejects([&] { corrupt_ints.deserializeBinary(huge_count); });
+    cout << (binary_ok ? "Binary serialization test passed\n" : "Binary serialization test failed\n");
+
+    // Тест потоковой сериализации: строковые потоки и файловый дескриптор
+    bool stream_ok = true;
+    for (TraversalType order : {TraversalType::PRE_ORDER, TraversalType::REVERSE_PRE_ORDER,
+                                TraversalType::POST_ORDER, TraversalType::REVERSE_POST_ORDER}) {
+        stringstream text_stream;
+        avl_tree.serialize(text_stream, order);
+        stream_ok = stream_ok && text_stream.str() == avl_tree.serialize(order);
+        BinaryTree<int> restored(BalancePolicy::AVL);
+        restored.deserialize(text_stream, order);
+        stream_ok = stream_ok && restored.serialize(order) == avl_tree.serialize(order);
+    }
+    stringstream binary_stream; // Два образа подряд в одном потоке
+    avl_tree.serializeBinary(binary_stream);
+    str_tree.serializeBinary(binary_stream);
+    BinaryTree<int> first_image;
+    BinaryTree<string> second_image;
+    first_image.deserializeBinary(binary_stream);
+    second_image.deserializeBinary(binary_stream);
+    stream_ok = stream_ok && first_image.serialize() == avl_tree.serialize() &&
+                second_image.serialize() == str_tree.serialize();
+    FILE* temp = tmpfile();
+    if (temp) {
+        int fd = fileno(temp);
+        str_tree.serializeToFd(fd);
+        lseek(fd, 0, SEEK_SET);
+        BinaryTree<string> from_fd;
+        from_fd.deserializeFromFd(fd);
+        stream_ok = stream_ok && from_fd.serialize() == str_tree.serialize();
+        lseek(fd, 0, SEEK_SET);
+        avl_tree.serializeBinaryToFd(fd);
+        lseek(fd, 0, SEEK_SET);
+        BinaryTree<int> binary_from_fd;
+        binary_from_fd.deserializeBinaryFromFd(fd);
+        stream_ok = stream_ok && binary_from_fd.serialize() == avl_tree.serialize();
+        // Два образа подряд в одном дескрипторе: упреждающее чтение первого не съедает второй
+        lseek(fd, 0, SEEK_SET);
+        avl_tree.serializeBinaryToFd(fd);
+        str_tree.serializeBinaryToFd(fd);
+        lseek(fd, 0, SEEK_SET);
+        BinaryTree<int> first_from_fd;
+        BinaryTree<string> second_from_fd;
+        first_from_fd.deserializeBinaryFromFd(fd);
+        second_from_fd.deserializeBinaryFromFd(fd);
+        stream_ok = stream_ok && first_from_fd.serialize() == avl_tree.serialize() &&
+                    second_from_fd.serialize() == str_tree.serialize();
+        fclose(temp);
+    }
+    cout << (stream_ok ? "Streaming serialization test passed\n" : "Streaming serialization test failed\n");
+
+    // Тест образа, отображённого в память
+    BinaryTree<int> image_source;
+    for (int i = 1; i <= 100; ++i) {
+        image_source.Insert(i * 3);
+    }
+    image_source.ExportImage("unit_test_image.bin");
+    str_tree.ExportImage("unit_test_strings.bin");
+    bool mapped_ok = false;
+    try {
+        MappedBinaryTree<int> mapped("unit_test_image.bin");
+        vector<int> mapped_values;
+        mapped.ForEach([&mapped_values](int value) { mapped_values.push_back(value); });
+        mapped_ok = mapped.Size() == 100 && mapped.Height() == 7 && mapped.Contains(3) && mapped.Contains(300) &&
+                    !mapped.Contains(4) && mapped.CountRange(10, 30) == 6 &&
+                    mapped_values == vector<int>(image_source.begin(), image_source.end()) &&
+                    mapped.GetByPath({"left"}) < mapped.GetByPath({}) &&
+                    mapped.GetByPath({}) < mapped.GetByPath({"right"}) &&
+                    mapped.GetByRelativePath(mapped.GetByPath({"left"}), {"right"}) == mapped.GetByPath({"left", "right"});
+
+        MappedBinaryTree<string> mapped_strings("unit_test_strings.bin");
+        mapped_ok = mapped_ok && mapped_strings.Size() == str_tree.Size() && mapped_strings.Contains("apple") &&
+                    mapped_strings.Contains("banana") && !mapped_strings.Contains("cherry");
+        try {
+            MappedBinaryTree<double> wrong_type("unit_test_image.bin"); // Чужой тип ключа
+            mapped_ok = false;
+        } catch (const SerializationError&) {
+        }
+    } catch (const TreeException& e) {
+        cout << e.what() << "\n";
+        mapped_ok = false;
+    }
+    remove("unit_test_image.bin");
+    remove("unit_test_strings.bin");
+    cout << (mapped_ok ? "Mapped image test passed\n" : "Mapped image test failed\n");
+
+    // Тест неизменяемого снимка
+    FrozenBinaryTree<int> frozen = image_source.Freeze();
+    vector<int> frozen_values(frozen.begin(), frozen.end());
+    vector<int> frozen_reverse(frozen.rbegin(), frozen.rend());
+    bool frozen_ok = frozen.Size() == image_source.Size() &&
+                     frozen_values == vector<int>(image_source.begin(), image_source.end()) &&
+                     equal(frozen_reverse.begin(), frozen_reverse.end(), frozen_values.rbegin()) &&
+                     frozen.TryContains(3) && frozen.TryContains(300) && !frozen.TryContains(301) &&
+                     frozen.Find(42) && *frozen.Find(42) == 42 && !frozen.Find(0) &&
+                     *frozen.lower_bound(10) == 12 && *frozen.upper_bound(12) == 15 &&
+                     frozen.lower_bound(301) == frozen.end() && frozen.CountRange(10, 30) == 6 &&
+                     frozen.CountRange(10, 30) == image_source.CountRange(10, 30) &&
+                     BinaryTree<int>().Freeze().begin() == BinaryTree<int>().Freeze().end();
+    try {
+        frozen.Contains(301);
+        frozen_ok = false;
+    } catch (const TreeException&) {
+    }
+    FrozenBinaryTree<string> frozen_strings = str_tree.Freeze();
+    frozen_ok = frozen_ok && frozen_strings.TryContains("apple") && !frozen_strings.TryContains("cherry");
+    cout << (frozen_ok ? "Frozen snapshot test passed\n" : "Frozen snapshot test failed\n");
+
+    // Тест дерева с многоключевыми узлами: сравнение с std::set на случайных вставках с повторами
+    auto block_matches_set = [](auto block_tree, auto make_key) {
+        using Key = decltype(make_key(0));
+        mt19937 block_gen(6);
+        uniform_int_distribution<int> block_dist(-5000, 5000);
+        std::set<Key> reference;
+        for (int i = 0; i < 20000; ++i) {
+            Key key = make_key(block_dist(block_gen));
+            block_tree.Insert(key);
+            reference.insert(key);
+        }
+        vector<Key> values;
+        block_tree.ForEach([&values](const Key& value) { values.push_back(value); });
+        bool ok = block_tree.Size() == reference.size() && values == vector<Key>(reference.begin(), reference.end());
+        for (int i = -5100; i <= 5100; i += 7) {
+            ok = ok && block_tree.TryContains(make_key(i)) == (reference.count(make_key(i)) > 0);
+        }
+        return ok;
+    };
+    bool block_ok = block_matches_set(BlockTree<int>(), [](int i) { return i; }) &&
+                    block_matches_set(BlockTree<int, false>(), [](int i) { return i; }) &&
+                    block_matches_set(BlockTree<float>(), [](int i) { return i * 0.5f; }) &&
+                    block_matches_set(BlockTree<double>(), [](int i) { return i * 0.25; });
+    BlockTree<int> extreme_block;
+    for (int value : {numeric_limits<int>::max(), numeric_limits<int>::min(), 0}) {
+        extreme_block.Insert(value);
+    }
+    block_ok = block_ok && extreme_block.Size() == 3 && extreme_block.TryContains(numeric_limits<int>::max()) &&
+               extreme_block.TryContains(numeric_limits<int>::min()) && !extreme_block.TryContains(1);
+    cout << (block_ok ? "Block tree test passed\n" : "Block tree test failed\n");
+
+    // Тест пакетного поиска: совпадение с поштучным TryContains/Find
+    vector<int> batch_keys;
+    for (int i = -10; i < 320; ++i) {
+        batch_keys.push_back(i);
+    }
+    shuffle(batch_keys.begin(), batch_keys.end(), mt19937(8));
+    bool batch_ok = true;
+    for (bool sorted : {false, true}) {
+        unique_ptr<bool[]> contained(new bool[batch_keys.size()]);
+        vector<const int*> found(batch_keys.size());
+        image_source.ContainsBatch(batch_keys.data(), batch_keys.size(), contained.get(), sorted);
+        image_source.FindBatch(batch_keys.data(), batch_keys.size(), found.data(), sorted);
+        for (size_t i = 0; i < batch_keys.size(); ++i) {
+            batch_ok = batch_ok && contained[i] == image_source.TryContains(batch_keys[i]) &&
+                       found[i] == image_source.Find(batch_keys[i]);
+        }
+    }
+    bool empty_result = true;
+    BinaryTree<int>().ContainsBatch(batch_keys.data(), 1, &empty_result);
+    image_source.ContainsBatch(nullptr, 0, nullptr);
+    batch_ok = batch_ok && !empty_result;
+    cout << (batch_ok ? "Batch lookup test passed\n" : "Batch lookup test failed\n");
+
+    // Тест параллельных map/where: те же значения, что у последовательных версий, и сбалансированный результат
+    BinaryTree<int> parallel_source;
+    mt19937 parallel_gen(10);
+    for (int i = 0; i < 50000; ++i) {
+        parallel_source.Insert(static_cast<int>(parallel_gen() % 200000));
+    }
+    auto values_of = [](const BinaryTree<int>& tree) { return vector<int>(tree.begin(), tree.end()); };
+    auto squash = [](int x) { return x / 3; }; // Склеивает соседние значения
+    auto even = [](int x) { return x % 2 == 0; };
+    bool parallel_ok = true;
+    for (unsigned threads : {1u, 3u, 8u}) {
+        BinaryTree<int> mapped_tree = parallel_source.parallelMap(squash, threads);
+        BinaryTree<int> filtered_tree = parallel_source.parallelWhere(even, threads);
+        parallel_ok = parallel_ok && values_of(mapped_tree) == values_of(parallel_source.map(squash)) &&
+                      values_of(filtered_tree) == values_of(parallel_source.where(even)) &&
+                      mapped_tree.Height() <= 17 && filtered_tree.Height() <= 16;
+    }
+    parallel_ok = parallel_ok && BinaryTree<int>().parallelMap(squash).IsEmpty();
+    try {
+        parallel_source.parallelMap([](int x) -> int {
+            if (x > 100000) {
+                throw runtime_error("mapper failure");
+            }
+            return x;
+        });
+        parallel_ok = false;
+    } catch (const TreeException&) {
+    }
+    cout << (parallel_ok ? "Parallel map/where test passed\n" : "Parallel map/where test failed\n");
+
+    // Нагрузочные тесты потокобезопасных деревьев
+    ConcurrentBinaryTree<int> shared_tree;
+    bool concurrent_ok = concurrent_stress<int>(shared_tree);
+    cout << (concurrent_ok ? "Concurrent tree stress test passed\n" : "Concurrent tree stress test failed\n");
+
+    LockFreeBinaryTree<int> lockfree_int;
+    LockFreeBinaryTree<double> lockfree_double;
+    LockFreeBinaryTree<int> contended_int;
+    LockFreeBinaryTree<double> contended_double;
+    bool lockfree_ok = concurrent_stress<int>(lockfree_int) && concurrent_stress<double>(lockfree_double) &&
+                       contended_stress(contended_int) && contended_stress(contended_double);
+    cout << (lockfree_ok ? "Lock-free tree stress test passed\n" : "Lock-free tree stress test failed\n");
+
+    // Тест персистентного дерева
+    // Каждая версия сверяется со своим std::set после всех последующих изменений
+    BinaryTree<int> persistent_source;
+    for (int value : {50, 30, 70, 20, 40, 60, 80}) {
+        persistent_source.Insert(value);
+    }
+    PersistentBinaryTree<int> version0 = persistent_source.Persist();
+    vector<PersistentBinaryTree<int>> versions{version0};
+    vector<set<int>> version_sets{set<int>(persistent_source.begin(), persistent_source.end())};
+    mt19937 persistent_gen(21);
+    for (int step = 0; step < 2000; ++step) {
+        int key = static_cast<int>(persistent_gen() % 500);
+        set<int> next_set = version_sets.back();
+        if (persistent_gen() % 3 == 0 && next_set.count(key)) {
+            versions.push_back(versions.back().Remove(key));
+            next_set.erase(key);
+        } else {
+            versions.push_back(versions.back().Insert(key));
+            next_set.insert(key);
+        }
+        version_sets.push_back(next_set);
+    }
+    bool persistent_ok = true;
+    for (size_t i = 0; i < versions.size(); i += 97) {
+        vector<int> values;
+        versions[i].ForEach([&values](int value) { values.push_back(value); });
+        persistent_ok = persistent_ok && versions[i].Size() == version_sets[i].size() &&
+                        values == vector<int>(version_sets[i].begin(), version_sets[i].end());
+    }
+    const PersistentBinaryTree<int>& latest = versions.back();
+    persistent_ok = persistent_ok && latest.Height() <= 2 * static_cast<size_t>(log2(latest.Size() + 1)) + 1;
+    // Копия и повторная вставка не создают узлов; поддерево разделяет узлы с версией
+    PersistentBinaryTree<int> copy_version = latest;
+    persistent_ok = persistent_ok && copy_version.SharesRootWith(latest) &&
+                    latest.Insert(*latest.Find(*version_sets.back().begin())).SharesRootWith(latest);
+    PersistentBinaryTree<int> subtree = version0.extractSubtree(30);
+    persistent_ok = persistent_ok && subtree.Size() == 3 && subtree.TryContains(20) && !subtree.TryContains(50) &&
+                    version0.CountRange(30, 70) == 4;
+    try {
+        version0.Remove(1000);
+        persistent_ok = false;
+    }
+    catch (const TreeException&) {}
+    // Писатель публикует версии, читатели берут снимки: снимок из k значений - ровно 0..k-1
+    VersionedTree<int> shared_versions;
+    atomic<bool> versions_done(false);
+    atomic<bool> snapshots_ok(true);
+    thread version_reader([&]() {
+        while (!versions_done) {
+            PersistentBinaryTree<int> snapshot = shared_versions.Snapshot();
+            int expected_value = 0;
+            snapshot.ForEach([&](int value) {
+                if (value != expected_value++) {
+                    snapshots_ok = false;
+                }
+            });
+            if (static_cast<size_t>(expected_value) != snapshot.Size()) {
+                snapshots_ok = false;
+            }
+        }
+    });
+    for (int value = 0; value < 5000; ++value) {
+        shared_versions.Update([value](const PersistentBinaryTree<int>& current) { return current.Insert(value); });
+    }
+    versions_done = true;
+    version_reader.join();
+    persistent_ok = persistent_ok && snapshots_ok && shared_versions.Snapshot().Size() == 5000;
+    cout << (persistent_ok ? "Persistent tree test passed\n" : "Persistent tree test failed\n");
+
+    // Статистика: размер и высота есть всегда, счётчики - только при сборке с BINARY_TREE_STATS
+    BinaryTree<int> stats_tree;
+    for (int value = 1; value <= 7; ++value) {
+        stats_tree.Insert(value); // Вырожденная цепочка: высота 7
+    }
+    stats_tree.Insert(3);
+    stats_tree.TryContains(7);
+    stats_tree.TryContains(100);
+    stats_tree.Remove(7);
+    TreeStats tree_stats = stats_tree.Stats();
+    bool tree_stats_ok = tree_stats.size == 6 && tree_stats.height == 6 && tree_stats.Degeneracy() == 2.0 &&
+                    tree_stats.ToJson().find("\"size\":6") != string::npos;
+    if (tree_stats.enabled) {
+        // Вставка 3: пройдено 3 узла; поиск 7 - 7 узлов, поиск 100 - 7 узлов
+        tree_stats_ok = tree_stats_ok && tree_stats.insert.calls == 8 && tree_stats.insert.hits == 7 &&
+                   tree_stats.insert.nodesVisited == 21 + 3 && tree_stats.contains.calls == 2 &&
+                   tree_stats.contains.hits == 1 && tree_stats.contains.maxNodesVisited == 7 &&
+                   tree_stats.remove.calls == 1 && tree_stats.remove.hits == 1 &&
+                   tree_stats.nodesAllocated == 7 && tree_stats.nodesFreed == 1 &&
+                   tree_stats.insert.latencyNs.Count() == 8 &&
+                   tree_stats.insert.latencyNs.Percentile(1.0) == tree_stats.insert.latencyNs.Max();
+        // Копия начинает с нулевых счётчиков, ResetStats обнуляет
+        BinaryTree<int> stats_copy(stats_tree);
+        stats_tree.ResetStats();
+        tree_stats_ok = tree_stats_ok && stats_copy.Stats().insert.calls == 0 && stats_tree.Stats().contains.calls == 0;
+    }
+    // Гистограмма: значения до 32 точны, дальше относительная погрешность ~3%
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.Record(value * 1000);
+    }
+    uint64_t median = histogram.Percentile(0.5);
+    tree_stats_ok = tree_stats_ok && histogram.Count() == 1000 && histogram.Min() == 1000 && histogram.Max() == 1000000 &&
+               median >= 500000 && median <= 500000 + 500000 / 32 && histogram.Percentile(1.0) == 1000000 &&
+               LatencyHistogram::BucketOf(31) == 31 && LatencyHistogram::BucketHigh(LatencyHistogram::BucketOf(12345)) >= 12345;
+    cout << (tree_stats_ok ? "Tree stats test passed\n" : "Tree stats test failed\n");
+
+    // Форма дерева и балансировка DSW: цепочка из 1000 узлов -> высота ceil(log2(1001)) = 10
+    BinaryTree<int> shape_tree;
+    for (int value = 1; value <= 1000; ++value) {
+        shape_tree.Insert(value);
+    }
+    TreeShape chain_shape = shape_tree.Analyze();
+    bool shape_ok = chain_shape.height == 1000 && chain_shape.optimalHeight == 10 && chain_shape.leaves == 1 &&
+                    chain_shape.oneChildNodes == 999 && chain_shape.maxLeafDepth == 1000 &&
+                    chain_shape.averageHitDepth == 500.5 && chain_shape.depthHistogram.size() == 1000 &&
+                    chain_shape.avlViolations == 998 &&
+                    chain_shape.balanceHistogram[0] == 992 && chain_shape.balanceHistogram[TreeShape::BALANCE_LIMIT - 1] == 1 &&
+                    chain_shape.ToJson().find("\"height\":1000") != string::npos;
+    shape_tree.Rebalance();
+    TreeShape balanced_shape = shape_tree.Analyze();
+    vector<int> balanced_values(shape_tree.begin(), shape_tree.end());
+    shape_ok = shape_ok && balanced_shape.height == 10 && shape_tree.Height() == 10 &&
+               balanced_shape.avlViolations == 0 && balanced_shape.oneChildNodes <= 1 &&
+               balanced_shape.maxLeafDepth - balanced_shape.minLeafDepth <= 1 &&
+               shape_tree.Size() == 1000 && balanced_values.size() == 1000 &&
+               balanced_values.front() == 1 && balanced_values.back() == 1000 &&
+               is_sorted(balanced_values.begin(), balanced_values.end());
+    // AVL-дерево с порядковыми статистиками: после Rebalance высоты и размеры узлов актуальны
+    BinaryTree<int> avl_shape_tree(BalancePolicy::AVL);
+    avl_shape_tree.EnableOrderStatistics();
+    for (int value = 0; value < 100; ++value) {
+        avl_shape_tree.Insert(value);
+    }
+    avl_shape_tree.Rebalance();
+    avl_shape_tree.Insert(100);
+    avl_shape_tree.Remove(50);
+    shape_ok = shape_ok && avl_shape_tree.Height() == avl_shape_tree.Analyze().height &&
+               avl_shape_tree.Rank(60) == 59 && avl_shape_tree.Select(99) == 100;
+    BinaryTree<int> empty_shape_tree;
+    empty_shape_tree.Rebalance();
+    shape_ok = shape_ok && empty_shape_tree.Analyze().height == 0 && empty_shape_tree.IsEmpty();
+    cout << (shape_ok ? "Tree shape test passed\n" : "Tree shape test failed\n");
+
+    // Перемещение ключей: Insert(T&&) забирает строку, повторная вставка аргумент не трогает
+    BinaryTree<string> move_tree(BalancePolicy::AVL);
+    string long_key(100, 'm');
+    move_tree.Insert(std::move(long_key));
+    string duplicate_key(100, 'm');
+    move_tree.Insert(std::move(duplicate_key));
+    move_tree.Emplace(100, 'a');
+    move_tree.Emplace("zzz");
+    bool move_ok = move_tree.Size() == 3 && duplicate_key == string(100, 'm') &&
+                   move_tree.TryContains(string(100, 'a')) && move_tree.TryContains("zzz");
+    // Удаление узла с двумя потомками переносит узел-преемник: указатели на другие значения действительны
+    BinaryTree<string> relink_tree;
+    for (const char* key : {"m", "f", "t", "c", "h", "p", "w", "g", "q"}) {
+        relink_tree.Insert(key);
+    }
+    const string* successor_value = relink_tree.Find("p");
+    const string* other_value = relink_tree.Find("g");
+    relink_tree.Remove("m");
+    vector<string> relinked(relink_tree.begin(), relink_tree.end());
+    move_ok = move_ok && relink_tree.Find("p") == successor_value && relink_tree.Find("g") == other_value &&
+              relinked == vector<string>{"c", "f", "g", "h", "p", "q", "t", "w"} &&
+              relink_tree.RemoveRange("d", "r") == 5 && relink_tree.Size() == 3;
+    // То же в AVL-дереве с порядковыми статистиками: высоты и размеры пересчитаны на месте преемника
+    BinaryTree<int> relink_avl(BalancePolicy::AVL);
+    relink_avl.EnableOrderStatistics();
+    for (int value = 0; value < 200; ++value) {
+        relink_avl.Insert(value);
+    }
+    for (int value = 0; value < 200; value += 3) {
+        relink_avl.Remove(value);
+    }
+    move_ok = move_ok && relink_avl.Size() == 133 && relink_avl.Rank(100) == 66 && relink_avl.Select(0) == 1 &&
+              relink_avl.Analyze().avlViolations == 0 && relink_avl.Height() == relink_avl.Analyze().height;
+    cout << (move_ok ? "Move insert test passed\n" : "Move insert test failed\n");
+
+    // Компаратор: поиск в дереве строк по string_view и const char* без временных строк
+    BinaryTree<string> fruit_tree(BalancePolicy::AVL);
+    for (const char* fruit : {"pear", "apple", "plum", "fig", "kiwi", "lime"}) {
+        fruit_tree.Insert(fruit);
+    }
+    string_view fig_view = string_view("figure").substr(0, 3);
+    bool compare_ok = fruit_tree.TryContains(fig_view) && fruit_tree.Contains("kiwi") &&
+                      !fruit_tree.TryContains(string_view("fi")) &&
+                      fruit_tree.Find(fig_view) && *fruit_tree.Find(fig_view) == "fig" &&
+                      fruit_tree.CountRange(string_view("b"), string_view("m")) == 3 &&
+                      *fruit_tree.lower_bound(string_view("l")) == "lime" && *fruit_tree.upper_bound("pear") == "plum" &&
+                      fruit_tree.equal_range(string_view("plum")).first != fruit_tree.equal_range(string_view("plum")).second;
+    vector<string> fruit_range;
+    fruit_tree.ForEachInRange(string_view("g"), string_view("q"),
+                              [&fruit_range](const string& fruit) { fruit_range.push_back(fruit); });
+    fruit_tree.Remove(string_view("pear"));
+    compare_ok = compare_ok && fruit_range == vector<string>{"kiwi", "lime", "pear", "plum"} && fruit_tree.Size() == 5 &&
+                 !fruit_tree.TryContains("pear");
+    // Обратный порядок: все упорядоченные операции следуют компаратору
+    BinaryTree<int, std::greater<int>> descending(BalancePolicy::AVL);
+    descending.EnableOrderStatistics();
+    for (int value = 1; value <= 10; ++value) {
+        descending.Insert(value);
+    }
+    vector<int> descending_values(descending.begin(), descending.end());
+    compare_ok = compare_ok && descending_values.front() == 10 && descending_values.back() == 1 &&
+                 descending.Rank(8) == 2 && descending.CountRange(7, 3) == 4 && *descending.lower_bound(11) == 10 &&
+                 descending.Select(0) == 10 && descending.Freeze().TryContains(4) &&
+                 descending.Persist().Insert(11).CountRange(11, 9) == 2 &&
+                 *descending.map([](int value) { return value * 2; }).begin() == 20;
+    // Массовая загрузка проверяет и сортирует вход компаратором дерева
+    using DescendingTree = BinaryTree<int, std::greater<int>>;
+    vector<int> shuffled_values = {4, 9, 1, 7, 4, 10};
+    DescendingTree bulk_descending = DescendingTree::FromSorted(descending_values.begin(), descending_values.end(),
+                                                                BalancePolicy::AVL, std::greater<int>());
+    DescendingTree range_descending = DescendingTree::FromRange(shuffled_values.begin(), shuffled_values.end(), true);
+    compare_ok = compare_ok && vector<int>(bulk_descending.begin(), bulk_descending.end()) == descending_values &&
+                 vector<int>(range_descending.begin(), range_descending.end()) == vector<int>{10, 9, 7, 4, 1};
+    // complex<double> - лексикографический порядок TreeLess, без operator< в std
+    BinaryTree<complex<double>> complex_tree;
+    for (double real : {2.0, 1.0, 3.0}) {
+        complex_tree.Insert({real, 1.0});
+        complex_tree.Insert({real, -1.0});
+    }
+    compare_ok = compare_ok && *complex_tree.begin() == complex<double>(1.0, -1.0) &&
+                 complex_tree.CountRange({1.0, 0.0}, {3.0, 0.0}) == 4;
+    cout << (compare_ok ? "Comparator test passed\n" : "Comparator test failed\n");
+
+    // Аллокатор с состоянием: деревья-результаты выделяют узлы из того же источника, что и исходное
+    AllocationCounter counter;
+    using CountedTree = BinaryTree<int, TreeLess<int>, CountingAllocator<int>>;
+    CountedTree counted(BalancePolicy::AVL, CountingAllocator<int>(counter));
+    for (int value = 1; value <= 100; ++value) {
+        counted.Insert(value);
+    }
+    size_t allocations_before = counter.allocations;
+    CountedTree counted_map = counted.map([](int value) { return value * 2; });
+    CountedTree counted_where = counted.where([](int value) { return value % 2 == 0; });
+    CountedTree counted_subtree = counted.extractSubtree(*counted.begin());
+    bool allocator_ok = counted_map.GetAllocator() == counted.GetAllocator() &&
+                        counted_where.GetAllocator() == counted.GetAllocator() &&
+                        counted_subtree.GetAllocator() == counted.GetAllocator() &&
+                        counter.allocations >= allocations_before + 3 && counted_map.Size() == 100 &&
+                        counted_where.Size() == 50 && counted_subtree.Size() == 1;
+    cout << (allocator_ok ? "Allocator test passed\n" : "Allocator test failed\n");
 }
 
 
@@ -224,13 +922,8 @@ int main() {
     cout << "Running unit tests...\n";
     unit_tests();
 
-    cout << "Running performance tests...\n";
-    performance_test();
-    cout << "Results saved to performance.csv\n";
-
-    cout << "Running performance tests large...\n";
-    performance_test_large();
-    cout << "Results saved to performance_large.csv\n";
+    cout << "Running deep chain regression test...\n";
+    performance_test_deep_chain(10000000);
 
 
     cout << "Running full feature test...\n";
@@ -0,0 +1,358 @@
+#ifndef BINARY_TREE_MAPPED_TREE_H
+#define BINARY_TREE_MAPPED_TREE_H
+
+#include "binary_tree.h"   // Исключения
+#include "tree_compare.h"  // Порядок ключей
+#include "binary_format.h" // Теги типов ключей
+#include "eytzinger.h"
+#include <cstdint>
+#include <cstdio>  // std::rename, std::remove
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+// Образ дерева для отображения в память (BinaryTree::ExportImage / MappedBinaryTree)
+//
+// [Header][выравнивание до 64][ключи: (count + 1) слотов в порядке Эйтцингера, слот 0 пустой][пул строк]
+// Ключи int/float/double/complex хранятся как есть; строка - ссылка StringRef {смещение, длина}
+// в пул строк. Внутри образа нет указателей, только смещения от начала файла,
+// поэтому его можно отобразить по любому адресу и сразу выполнять поиск.
+// Порядок байт - родной для машины (проверяется по полю byteOrder)
+namespace mapped_image {
+
+constexpr char MAGIC[4] = {'B', 'T', 'M', 'I'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint64_t ALIGNMENT = 64; // Ключи начинаются с границы кэш-линии
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t keyTag;     // binary_format::KeyCodec<T>::TAG
+    uint64_t count;      // Количество ключей
+    uint64_t keysOffset; // Начало массива слотов
+    uint64_t poolOffset; // Начало пула строк
+    uint64_t poolSize;
+};
+
+// Ключ-строка в образе
+struct StringRef {
+    uint64_t offset; // Смещение в пуле строк
+    uint64_t length;
+};
+
+// Как ключ типа T лежит в образе (Stored) и как возвращается из него (View)
+template <typename T>
+struct KeyTraits {
+    static_assert(std::is_trivially_copyable<T>::value, "key type needs a dedicated image layout");
+    using Stored = T;
+    using View = T;
+
+    static View Get(const Stored& stored, const char*, uint64_t) {
+        return stored;
+    }
+};
+
+template <>
+struct KeyTraits<std::string> {
+    using Stored = StringRef;
+    using View = std::string_view; // Указывает прямо в отображённый файл
+
+    static View Get(const Stored& stored, const char* pool, uint64_t poolSize) {
+        // Содержимое файла не проверяется при открытии (открытие - O(1)), поэтому проверка здесь
+        if (stored.offset > poolSize || stored.length > poolSize - stored.offset) {
+            throw SerializationError("string reference is outside the string pool");
+        }
+        return View(pool + stored.offset, static_cast<size_t>(stored.length));
+    }
+};
+
+inline uint64_t AlignUp(uint64_t value) {
+    return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+// Запись образа по ключам, уже разложенным по слотам (slots[0] не используется)
+// Файл пишется во временный и переименовывается: читатели никогда не видят половину образа
+template <typename T>
+void WriteImage(const std::string& path, const std::vector<const T*>& slots) {
+    using Traits = KeyTraits<T>;
+    const uint64_t count = slots.empty() ? 0 : slots.size() - 1;
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.keyTag = binary_format::KeyCodec<T>::TAG;
+    header.count = count;
+    header.keysOffset = AlignUp(sizeof(Header));
+    header.poolOffset = AlignUp(header.keysOffset + (count + 1) * sizeof(typename Traits::Stored));
+    header.poolSize = 0;
+    if constexpr (std::is_same<T, std::string>::value) {
+        for (uint64_t k = 1; k <= count; ++k) {
+            header.poolSize += slots[k]->size();
+        }
+    }
+
+    const std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw TreeException("Cannot create tree image: " + temporary);
+    }
+    auto pad = [&out](uint64_t from, uint64_t to) {
+        static const char zeros[ALIGNMENT] = {};
+        out.write(zeros, static_cast<std::streamsize>(to - from));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad(sizeof(header), header.keysOffset);
+
+    typename Traits::Stored empty{};
+    out.write(reinterpret_cast<const char*>(&empty), sizeof(empty)); // Слот 0
+    uint64_t poolPosition = 0;
+    for (uint64_t k = 1; k <= count; ++k) {
+        if constexpr (std::is_same<T, std::string>::value) {
+            StringRef ref{poolPosition, slots[k]->size()};
+            poolPosition += ref.length;
+            out.write(reinterpret_cast<const char*>(&ref), sizeof(ref));
+        } else {
+            out.write(reinterpret_cast<const char*>(slots[k]), sizeof(T));
+        }
+    }
+    pad(header.keysOffset + (count + 1) * sizeof(empty), header.poolOffset);
+
+    if constexpr (std::is_same<T, std::string>::value) {
+        for (uint64_t k = 1; k <= count; ++k) {
+            out.write(slots[k]->data(), static_cast<std::streamsize>(slots[k]->size()));
+        }
+    }
+
+    out.close();
+    if (!out) {
+        std::remove(temporary.c_str());
+        throw TreeException("Cannot write tree image: " + temporary);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw TreeException("Cannot replace tree image: " + path);
+    }
+}
+
+} // namespace mapped_image
+
+// Дерево только для чтения поверх отображённого в память образа
+// Открытие - один mmap и проверка заголовка, время не зависит от размера дерева:
+// страницы подгружаются ОС по мере поиска. Узлы не создаются, данные не копируются.
+// Форма - полное сбалансированное дерево (высота ceil(log2(n + 1))),
+// пути GetByPath отсчитываются по ней, а не по форме исходного BinaryTree.
+// Compare должен совпадать с порядком дерева, записавшего образ (для строк сравниваются string_view)
+template <typename T, typename Compare = TreeLess<T>>
+class MappedBinaryTree {
+public:
+    using Traits = mapped_image::KeyTraits<T>;
+    using Stored = typename Traits::Stored;
+    using Key = typename Traits::View; // T или std::string_view для строк
+
+    explicit MappedBinaryTree(const std::string& path, const Compare& comparator = Compare())
+        : data(nullptr), length(0), keys(nullptr), pool(nullptr), count(0), poolSize(0), compare(comparator) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw TreeException("Cannot open tree image: " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < sizeof(mapped_image::Header)) {
+            ::close(fd);
+            throw SerializationError("tree image is truncated: " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // Отображение остаётся действительным и без дескриптора
+        if (mapping == MAP_FAILED) {
+            throw TreeException("Cannot map tree image: " + path);
+        }
+        data = static_cast<const char*>(mapping);
+        try {
+            Validate();
+        }
+        catch (...) {
+            Unmap();
+            throw;
+        }
+    }
+
+    // Отображение не копируется, только перемещается
+    MappedBinaryTree(const MappedBinaryTree&) = delete;
+    MappedBinaryTree& operator=(const MappedBinaryTree&) = delete;
+
+    MappedBinaryTree(MappedBinaryTree&& other) noexcept
+        : data(other.data), length(other.length), keys(other.keys), pool(other.pool), count(other.count),
+          poolSize(other.poolSize), compare(other.compare) {
+        other.data = nullptr;
+        other.length = 0;
+        other.count = 0;
+    }
+
+    MappedBinaryTree& operator=(MappedBinaryTree&& other) noexcept {
+        if (this != &other) {
+            Unmap();
+            data = other.data;
+            length = other.length;
+            keys = other.keys;
+            pool = other.pool;
+            count = other.count;
+            poolSize = other.poolSize;
+            compare = other.compare;
+            other.data = nullptr;
+            other.length = 0;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    ~MappedBinaryTree() {
+        Unmap();
+    }
+
+    size_t Size() const {
+        return count;
+    }
+
+    bool IsEmpty() const {
+        return count == 0;
+    }
+
+    size_t Height() const {
+        return eytzinger::Height(count);
+    }
+
+    bool Contains(const Key& value) const {
+        return Find(value) != 0;
+    }
+
+    // Обход значений из [lo, hi) по возрастанию (как у BinaryTree): спуск к lo, затем переходы к следующей позиции
+    template <typename Action>
+    void ForEachInRange(const Key& lo, const Key& hi, Action&& action) const {
+        if (!compare(lo, hi)) {
+            return;
+        }
+        for (size_t k = LowerBound(lo); k != 0; k = eytzinger::Next(k, count)) {
+            Key value = At(k);
+            if (!compare(value, hi)) {
+                break;
+            }
+            action(value);
+        }
+    }
+
+    size_t CountRange(const Key& lo, const Key& hi) const {
+        size_t result = 0;
+        ForEachInRange(lo, hi, [&result](const Key&) { ++result; });
+        return result;
+    }
+
+    // Обход всех значений по возрастанию
+    template <typename Action>
+    void ForEach(Action&& action) const {
+        for (size_t k = eytzinger::First(count); k != 0; k = eytzinger::Next(k, count)) {
+            action(At(k));
+        }
+    }
+
+    // Значение по пути от корня (вектор направлений "left"/"right")
+    Key GetByPath(const std::vector<std::string>& path) const {
+        if (count == 0) {
+            throw NodeNotFound("Tree is empty - path cannot be traversed");
+        }
+        return At(Walk(1, path, "Path leads to non-existent node"));
+    }
+
+    // Значение по пути от узла со значением base
+    Key GetByRelativePath(const Key& base, const std::vector<std::string>& path) const {
+        size_t k = Find(base);
+        if (k == 0) {
+            throw NodeNotFound("Base node with value not found");
+        }
+        return At(Walk(k, path, "Path leads to non-existent node from base"));
+    }
+
+private:
+    const char* data;    // Начало отображения
+    size_t length;       // Размер отображения
+    const Stored* keys;  // Слоты 0..count
+    const char* pool;    // Пул строк
+    size_t count;
+    uint64_t poolSize;
+    Compare compare;
+
+    void Validate() {
+        mapped_image::Header header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, mapped_image::MAGIC, sizeof(header.magic)) != 0) {
+            throw SerializationError("not a tree image");
+        }
+        if (header.version != mapped_image::VERSION) {
+            throw SerializationError("unsupported tree image version " + std::to_string(header.version));
+        }
+        if (header.byteOrder != mapped_image::BYTE_ORDER_MARK) {
+            throw SerializationError("tree image was written with a different byte order");
+        }
+        if (header.keyTag != binary_format::KeyCodec<T>::TAG) {
+            throw SerializationError("key type does not match the tree image");
+        }
+        // Все секции должны лежать внутри файла (проверка без чтения самих ключей)
+        const uint64_t slotsBytes = (header.count + 1) * sizeof(Stored);
+        if (header.count >= length / sizeof(Stored) || header.keysOffset % alignof(Stored) != 0 ||
+            header.keysOffset > length || slotsBytes > length - header.keysOffset ||
+            header.poolOffset > length || header.poolSize > length - header.poolOffset) {
+            throw SerializationError("tree image is truncated or corrupted");
+        }
+        keys = reinterpret_cast<const Stored*>(data + header.keysOffset);
+        pool = data + header.poolOffset;
+        count = static_cast<size_t>(header.count);
+        poolSize = header.poolSize;
+    }
+
+    void Unmap() noexcept {
+        if (data) {
+            ::munmap(const_cast<char*>(data), length);
+            data = nullptr;
+        }
+    }
+
+    Key At(size_t k) const {
+        return Traits::Get(keys[k], pool, poolSize);
+    }
+
+    size_t LowerBound(const Key& value) const {
+        return eytzinger::LowerBound(count, [this, &value](size_t k) { return compare(At(k), value); });
+    }
+
+    // Позиция значения (0 - не найдено)
+    size_t Find(const Key& value) const {
+        size_t k = LowerBound(value);
+        return (k != 0 && !compare(value, At(k))) ? k : 0;
+    }
+
+    size_t Walk(size_t k, const std::vector<std::string>& path, const char* missing) const {
+        for (const auto& direction : path) {
+            if (direction != "left" && direction != "right") {
+                throw InvalidTreeOperation("Invalid path direction: " + direction);
+            }
+            k = 2 * k + (direction == "right" ? 1 : 0);
+            if (k > count) {
+                throw NodeNotFound(missing);
+            }
+        }
+        return k;
+    }
+};
+
+#endif
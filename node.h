@@ -1,6 +1,7 @@
 #include <iostream>
+#include <utility>
 
-#ifndef BINARI_TREE_NODE_H
+#ifndef BINARY_TREE_NODE_H
 #define BINARY_TREE_NODE_H
 
 template <typename T>
@@ -8,11 +9,15 @@ struct Node {
     T data; // значение, хранящееся в узле
     Node<T>* left; // указатель на левого потомка
     Node<T>* right; // указатель на правого потомка
+    int height; // высота поддерева с корнем в этом узле (лист = 1), нужна для AVL-балансировки
+    size_t subtreeSize; // количество узлов в поддереве (для порядковых статистик Rank/Select)
 
     // Constructor
     // explicit запрещает неявное преобразование T к Node
     // Принимает const T& - константную ссылку на значение
-    explicit Node(const T& value) : data(value), left(nullptr), right(nullptr) {}
+    explicit Node(const T& value) : data(value), left(nullptr), right(nullptr), height(1), subtreeSize(1) {}
+    // Перемещение значения в узел (без копии ключа, например строки)
+    explicit Node(T&& value) : data(std::move(value)), left(nullptr), right(nullptr), height(1), subtreeSize(1) {}
 
     // Destructor (по умолчанию)
     // Для избегания double free
@@ -22,6 +27,8 @@ struct Node {
     // Все узлы копируются рекурсией
     Node<T>* copy() const {
         Node<T>* newNode = new Node<T>(data);
+        newNode->height = height;
+        newNode->subtreeSize = subtreeSize;
         
         if (left) newNode->left = left->copy();
         if (right) newNode->right = right->copy();
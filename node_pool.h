@@ -0,0 +1,171 @@
+#ifndef BINARY_TREE_NODE_POOL_H
+#define BINARY_TREE_NODE_POOL_H
+
+#include "node.h"
+#include <cstddef>
+#include <memory> // std::allocator, std::allocator_traits
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Пул узлов дерева (slab/arena)
+// Память под узлы выделяется блоками (chunk) через Allocator, освобождённые узлы
+// попадают в список свободных и переиспользуются при следующей вставке.
+// Release() возвращает всю память разом - за O(количества блоков), а не O(узлов)
+template <typename T, typename Allocator = std::allocator<T>>
+class NodePool {
+public:
+    // Аллокатор, перепривязанный с T на Node<T>
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node<T>>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    // Можно ли освобождать блоки, не вызывая деструкторы узлов
+    static constexpr bool TRIVIAL_RELEASE = std::is_trivially_destructible<T>::value;
+
+    explicit NodePool(const Allocator& allocator = Allocator())
+        : alloc(allocator), freeList(nullptr), used(0), nextCapacity(MIN_CHUNK) {}
+
+    // Пул владеет памятью - копирование запрещено, перемещение передаёт все блоки
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    NodePool(NodePool&& other) noexcept
+        : alloc(std::move(other.alloc)), chunks(std::move(other.chunks)), freeList(other.freeList),
+          used(other.used), nextCapacity(other.nextCapacity) {
+        other.Reset();
+    }
+
+    NodePool& operator=(NodePool&& other) noexcept {
+        if (this != &other) {
+            Release();
+            alloc = std::move(other.alloc);
+            chunks = std::move(other.chunks);
+            freeList = other.freeList;
+            used = other.used;
+            nextCapacity = other.nextCapacity;
+            other.Reset();
+        }
+        return *this;
+    }
+
+    ~NodePool() {
+        Release();
+    }
+
+    // Создание узла в памяти пула (сначала из списка свободных, затем из текущего блока)
+    template <typename... Args>
+    Node<T>* Create(Args&&... args) {
+        Node<T>* slot = Acquire();
+        try {
+            NodeTraits::construct(alloc, slot, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            Recycle(slot); // Память возвращается в пул, исключение летит дальше
+            throw;
+        }
+        return slot;
+    }
+
+    // Уничтожение узла: деструктор и возврат памяти в список свободных
+    void Destroy(Node<T>* node) {
+        if (!node) {
+            return;
+        }
+        NodeTraits::destroy(alloc, node);
+        Recycle(node);
+    }
+
+    // Резервирование места минимум под count узлов одним блоком
+    void Reserve(size_t count) {
+        size_t available = chunks.empty() ? 0 : chunks.back().capacity - used;
+        if (count > available) {
+            AddChunk(count);
+        }
+    }
+
+    // Освобождение всех блоков
+    // Деструкторы узлов здесь не вызываются: для нетривиальных T их нужно вызвать заранее
+    void Release() noexcept {
+        for (const Chunk& chunk : chunks) {
+            NodeTraits::deallocate(alloc, chunk.nodes, chunk.capacity);
+        }
+        chunks.clear();
+        freeList = nullptr;
+        used = 0;
+        nextCapacity = MIN_CHUNK;
+    }
+
+    // Количество выделенных блоков
+    size_t ChunkCount() const {
+        return chunks.size();
+    }
+
+    Allocator GetAllocator() const {
+        return Allocator(alloc);
+    }
+
+private:
+    static constexpr size_t MIN_CHUNK = 64;       // Размер первого блока (в узлах)
+    static constexpr size_t MAX_CHUNK = 1 << 16;  // Предел геометрического роста блоков
+
+    // Блок памяти под capacity узлов
+    struct Chunk {
+        Node<T>* nodes;
+        size_t capacity;
+    };
+
+    // Свободный слот: в памяти уничтоженного узла хранится ссылка на следующий
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+    static_assert(sizeof(Node<T>) >= sizeof(FreeSlot), "Node must fit a free-list link");
+
+    NodeAllocator alloc;
+    std::vector<Chunk> chunks;
+    FreeSlot* freeList; // Список свободных слотов
+    size_t used;        // Занятые слоты в последнем блоке
+    size_t nextCapacity;
+
+    // Сброс состояния после передачи блоков другому пулу
+    void Reset() noexcept {
+        chunks.clear();
+        freeList = nullptr;
+        used = 0;
+        nextCapacity = MIN_CHUNK;
+    }
+
+    Node<T>* Acquire() {
+        if (freeList) {
+            FreeSlot* slot = freeList;
+            freeList = slot->next;
+            return reinterpret_cast<Node<T>*>(slot);
+        }
+        if (chunks.empty() || used == chunks.back().capacity) {
+            AddChunk(nextCapacity);
+            if (nextCapacity < MAX_CHUNK) {
+                nextCapacity *= 2;
+            }
+        }
+        return chunks.back().nodes + used++;
+    }
+
+    void Recycle(Node<T>* node) noexcept {
+        freeList = ::new (static_cast<void*>(node)) FreeSlot{freeList};
+    }
+
+    void AddChunk(size_t capacity) {
+        // Остаток текущего блока не теряется - он уходит в список свободных
+        if (!chunks.empty()) {
+            for (; used < chunks.back().capacity; ++used) {
+                Recycle(chunks.back().nodes + used);
+            }
+        }
+        chunks.reserve(chunks.size() + 1); // Чтобы push_back ниже не бросал после allocate
+        Node<T>* nodes = NodeTraits::allocate(alloc, capacity);
+        chunks.push_back({nodes, capacity});
+        used = 0;
+    }
+};
+
+#endif
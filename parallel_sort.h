@@ -0,0 +1,63 @@
+#ifndef BINARY_TREE_PARALLEL_SORT_H
+#define BINARY_TREE_PARALLEL_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+// Параллельная сортировка диапазона
+// Диапазон делится на threads частей, каждая сортируется в своём потоке,
+// затем соседние части попарно сливаются (inplace_merge) - log2(threads) раундов
+template <typename RandomIt, typename Compare>
+void ParallelSort(RandomIt first, RandomIt last, Compare comp, unsigned threads = std::thread::hardware_concurrency()) {
+    const size_t size = static_cast<size_t>(std::distance(first, last));
+    const size_t MIN_PART = 1 << 14; // Мелкие части не окупают запуск потока
+    if (threads == 0) {
+        threads = 1;
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, size / MIN_PART)));
+    if (threads <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // Границы частей
+    std::vector<RandomIt> bounds;
+    for (unsigned i = 0; i <= threads; ++i) {
+        bounds.push_back(first + static_cast<std::ptrdiff_t>(size * i / threads));
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([&bounds, &comp, i]() { std::sort(bounds[i], bounds[i + 1], comp); });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Попарное слияние отсортированных частей
+    for (size_t step = 1; step < threads; step *= 2) {
+        workers.clear();
+        for (size_t i = 0; i + step < threads; i += 2 * step) {
+            RandomIt begin = bounds[i];
+            RandomIt middle = bounds[i + step];
+            RandomIt end = bounds[std::min<size_t>(i + 2 * step, threads)];
+            workers.emplace_back([begin, middle, end, &comp]() { std::inplace_merge(begin, middle, end, comp); });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+// Параллельная сортировка по возрастанию (operator<)
+template <typename RandomIt>
+void ParallelSort(RandomIt first, RandomIt last, unsigned threads = std::thread::hardware_concurrency()) {
+    ParallelSort(first, last, std::less<>(), threads);
+}
+
+#endif
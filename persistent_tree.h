@@ -0,0 +1,340 @@
+#ifndef BINARY_TREE_PERSISTENT_TREE_H
+#define BINARY_TREE_PERSISTENT_TREE_H
+
+#include "exceptions.h"
+#include "tree_compare.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Персистентное (версионное) AVL-дерево поиска с копированием пути
+// Узлы неизменяемы и разделяются версиями через std::shared_ptr. Insert/Remove не меняют дерево,
+// а возвращают новую версию: копируются только узлы пути от корня до места изменения
+// (O(log n) узлов), остальные поддеревья общие со старой версией.
+// Копирование, присваивание и extractSubtree - O(1) (разделяется корень). Узел освобождается,
+// когда его не использует ни одна версия (счётчик ссылок shared_ptr атомарен).
+// Версия неизменяема, поэтому её можно читать из любого числа потоков одновременно,
+// пока другие потоки строят новые версии (общая "текущая" версия - VersionedTree ниже).
+// Порядок Compare переходит ко всем версиям, построенным из этой
+template <typename T, typename Compare = TreeLess<T>>
+class PersistentBinaryTree {
+    struct PNode;
+    using NodePtr = std::shared_ptr<const PNode>;
+
+public:
+    explicit PersistentBinaryTree(const Compare& comparator = Compare()) : compare(comparator) {}
+
+    // Построение из строго возрастающей последовательности (например, BinaryTree::begin()/end())
+    // за O(n): сразу сбалансированное дерево. Нарушение порядка - InvalidTreeOperation
+    template <typename ForwardIt>
+    PersistentBinaryTree(ForwardIt first, ForwardIt last, const Compare& comparator = Compare())
+        : compare(comparator) {
+        std::vector<T> values(first, last);
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (!compare(values[i - 1], values[i])) {
+                throw InvalidTreeOperation("PersistentBinaryTree requires strictly increasing values");
+            }
+        }
+        root = Build(values.data(), values.size());
+    }
+
+    // Новая версия со вставленным значением (значение уже есть - та же версия)
+    PersistentBinaryTree Insert(const T& value) const {
+        bool changed = false;
+        NodePtr result = InsertInto(root, value, changed);
+        return changed ? PersistentBinaryTree(std::move(result), compare) : *this;
+    }
+
+    // Новая версия без значения (значения нет - TreeException, как в BinaryTree::Remove)
+    PersistentBinaryTree Remove(const T& value) const {
+        bool changed = false;
+        NodePtr result = RemoveFrom(root, value, changed);
+        if (!changed) {
+            throw TreeException("Cannot remove - value not found in tree");
+        }
+        return PersistentBinaryTree(std::move(result), compare);
+    }
+
+    // Проверка существования (промах и пустое дерево - TreeException, как в BinaryTree::Contains)
+    bool Contains(const T& value) const {
+        if (IsEmpty()) {
+            throw TreeException("Tree is empty - cannot check containment");
+        }
+        if (!Find(value)) {
+            throw TreeException("Value not found");
+        }
+        return true;
+    }
+
+    // Проверка существования без исключений
+    bool TryContains(const T& value) const noexcept {
+        return Find(value) != nullptr;
+    }
+
+    // Указатель на хранимое значение или nullptr (действителен, пока жива версия, содержащая узел)
+    const T* Find(const T& value) const noexcept {
+        const PNode* node = root.get();
+        while (node) {
+            const int order = KeyOrder(compare, value, node->data);
+            if (order < 0) {
+                node = node->left.get();
+            } else if (order > 0) {
+                node = node->right.get();
+            } else {
+                return &node->data;
+            }
+        }
+        return nullptr;
+    }
+
+    // Поддерево с корнем в узле value - за O(1), узлы общие с этой версией
+    // Значения нет - NodeNotFound, как в BinaryTree::extractSubtree
+    PersistentBinaryTree extractSubtree(const T& value) const {
+        const NodePtr* link = &root;
+        while (*link) {
+            const PNode* node = link->get();
+            const int order = KeyOrder(compare, value, node->data);
+            if (order < 0) {
+                link = &node->left;
+            } else if (order > 0) {
+                link = &node->right;
+            } else {
+                return PersistentBinaryTree(*link, compare);
+            }
+        }
+        throw NodeNotFound("Value not found in tree - cannot extract subtree");
+    }
+
+    size_t Size() const { return NodeSize(root); }
+    bool IsEmpty() const { return !root; }
+    // Высота дерева (пустое = 0, один узел = 1)
+    size_t Height() const { return static_cast<size_t>(NodeHeight(root)); }
+
+    // Количество значений в [lo, hi) за O(log n): размеры поддеревьев хранятся в узлах
+    size_t CountRange(const T& lo, const T& hi) const {
+        if (!compare(lo, hi)) {
+            return 0;
+        }
+        return CountLess(hi) - CountLess(lo);
+    }
+
+    // Вызов action(const T&) для значений из [lo, hi) по возрастанию (поддеревья вне границ не посещаются)
+    template <typename Action>
+    void ForEachInRange(const T& lo, const T& hi, Action&& action) const {
+        if (!compare(lo, hi)) {
+            return;
+        }
+        std::vector<const PNode*> stack;
+        const PNode* node = root.get();
+        while (node || !stack.empty()) {
+            while (node) {
+                if (compare(node->data, lo)) {
+                    node = node->right.get(); // Левое поддерево целиком меньше lo
+                } else {
+                    stack.push_back(node);
+                    node = node->left.get();
+                }
+            }
+            if (stack.empty()) {
+                break;
+            }
+            node = stack.back();
+            stack.pop_back();
+            if (!compare(node->data, hi)) {
+                break;
+            }
+            action(node->data);
+            node = node->right.get();
+        }
+    }
+
+    // Обход всех значений по возрастанию (явный стек)
+    template <typename Action>
+    void ForEach(Action&& action) const {
+        std::vector<const PNode*> stack;
+        const PNode* node = root.get();
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left.get();
+            }
+            node = stack.back();
+            stack.pop_back();
+            action(node->data);
+            node = node->right.get();
+        }
+    }
+
+    // Используют ли версии один и тот же корень (изменения одной не коснулись другой)
+    bool SharesRootWith(const PersistentBinaryTree& other) const {
+        return root == other.root;
+    }
+
+private:
+    // Неизменяемый узел: после создания меняется только счётчик ссылок
+    struct PNode {
+        T data;
+        NodePtr left;
+        NodePtr right;
+        int height;
+        size_t size;
+
+        PNode(const T& value, NodePtr l, NodePtr r)
+            : data(value), left(std::move(l)), right(std::move(r)),
+              height(1 + std::max(NodeHeight(left), NodeHeight(right))),
+              size(1 + NodeSize(left) + NodeSize(right)) {}
+    };
+
+    NodePtr root;
+    Compare compare;
+
+    PersistentBinaryTree(NodePtr node, const Compare& comparator) : root(std::move(node)), compare(comparator) {}
+
+    static int NodeHeight(const NodePtr& node) { return node ? node->height : 0; }
+    static size_t NodeSize(const NodePtr& node) { return node ? node->size : 0; }
+
+    static NodePtr MakeNode(const T& value, NodePtr left, NodePtr right) {
+        return std::make_shared<const PNode>(value, std::move(left), std::move(right));
+    }
+
+    // Сбалансированный узел из значения и двух AVL-поддеревьев, высоты которых отличаются не больше чем на 2
+    // Вместо поворота существующих узлов создаются новые (старые остаются в прежних версиях)
+    static NodePtr Balanced(const T& value, const NodePtr& left, const NodePtr& right) {
+        int difference = NodeHeight(left) - NodeHeight(right);
+        if (difference > 1) {
+            if (NodeHeight(left->left) >= NodeHeight(left->right)) {
+                // Малый правый поворот
+                return MakeNode(left->data, left->left, MakeNode(value, left->right, right));
+            }
+            // Большой правый поворот
+            const NodePtr& middle = left->right;
+            return MakeNode(middle->data, MakeNode(left->data, left->left, middle->left),
+                            MakeNode(value, middle->right, right));
+        }
+        if (difference < -1) {
+            if (NodeHeight(right->right) >= NodeHeight(right->left)) {
+                return MakeNode(right->data, MakeNode(value, left, right->left), right->right);
+            }
+            const NodePtr& middle = right->left;
+            return MakeNode(middle->data, MakeNode(value, left, middle->left),
+                            MakeNode(right->data, middle->right, right->right));
+        }
+        return MakeNode(value, left, right);
+    }
+
+    // Рекурсия по пути: глубина - высота AVL-дерева (не больше 1.45 log2 n)
+    NodePtr InsertInto(const NodePtr& node, const T& value, bool& changed) const {
+        if (!node) {
+            changed = true;
+            return MakeNode(value, nullptr, nullptr);
+        }
+        const int order = KeyOrder(compare, value, node->data);
+        if (order < 0) {
+            NodePtr left = InsertInto(node->left, value, changed);
+            return changed ? Balanced(node->data, left, node->right) : node;
+        }
+        if (order > 0) {
+            NodePtr right = InsertInto(node->right, value, changed);
+            return changed ? Balanced(node->data, node->left, right) : node;
+        }
+        return node;
+    }
+
+    NodePtr RemoveFrom(const NodePtr& node, const T& value, bool& changed) const {
+        if (!node) {
+            return node;
+        }
+        const int order = KeyOrder(compare, value, node->data);
+        if (order < 0) {
+            NodePtr left = RemoveFrom(node->left, value, changed);
+            return changed ? Balanced(node->data, left, node->right) : node;
+        }
+        if (order > 0) {
+            NodePtr right = RemoveFrom(node->right, value, changed);
+            return changed ? Balanced(node->data, node->left, right) : node;
+        }
+        changed = true;
+        if (!node->left) {
+            return node->right;
+        }
+        if (!node->right) {
+            return node->left;
+        }
+        // Два ребёнка: значение узла заменяется минимумом правого поддерева
+        const PNode* successor = node->right.get();
+        while (successor->left) {
+            successor = successor->left.get();
+        }
+        bool removed = false;
+        NodePtr right = RemoveFrom(node->right, successor->data, removed);
+        return Balanced(successor->data, node->left, right);
+    }
+
+    // Идеально сбалансированное поддерево из count отсортированных значений
+    static NodePtr Build(const T* values, size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        size_t middle = count / 2;
+        NodePtr left = Build(values, middle);
+        NodePtr right = Build(values + middle + 1, count - middle - 1);
+        return MakeNode(values[middle], std::move(left), std::move(right));
+    }
+
+    // Количество значений, строго меньших value
+    size_t CountLess(const T& value) const {
+        size_t result = 0;
+        const PNode* node = root.get();
+        while (node) {
+            if (compare(node->data, value)) {
+                result += NodeSize(node->left) + 1;
+                node = node->right.get();
+            } else {
+                node = node->left.get();
+            }
+        }
+        return result;
+    }
+};
+
+// Общая текущая версия для нескольких потоков
+// Snapshot() - согласованная версия за O(1) (короткая блокировка на копирование корня),
+// читатели работают со своими снимками без блокировок. Писатели выполняются по очереди:
+// Update(change) строит новую версию из текущей вне блокировки читателей и публикует её
+template <typename T, typename Compare = TreeLess<T>>
+class VersionedTree {
+public:
+    VersionedTree() = default;
+    explicit VersionedTree(PersistentBinaryTree<T, Compare> initial) : head(std::move(initial)) {}
+
+    VersionedTree(const VersionedTree&) = delete;
+    VersionedTree& operator=(const VersionedTree&) = delete;
+
+    PersistentBinaryTree<T, Compare> Snapshot() const {
+        std::lock_guard<std::mutex> lock(headMutex);
+        return head;
+    }
+
+    // change(const PersistentBinaryTree<T, Compare>&) возвращает новую версию
+    template <typename Change>
+    void Update(Change&& change) {
+        std::lock_guard<std::mutex> writer(writerMutex);
+        PersistentBinaryTree<T, Compare> next = change(Snapshot());
+        {
+            std::lock_guard<std::mutex> lock(headMutex);
+            std::swap(head, next);
+        }
+        // Старая версия (в next) освобождается вне блокировки читателей
+    }
+
+private:
+    mutable std::mutex headMutex;
+    std::mutex writerMutex;
+    PersistentBinaryTree<T, Compare> head;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef BINARY_TREE_SIMD_SEARCH_H
+#define BINARY_TREE_SIMD_SEARCH_H
+
+#include <bitset>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define BINARY_TREE_HAS_SSE2 1
+#endif
+
+// Поиск внутри блока отсортированных ключей: сколько ключей строго меньше x
+// Для блоков в одну кэш-линию (16 x int/float, 8 x double) сравниваются сразу все ключи
+// векторными инструкциями (AVX/AVX2, иначе SSE2), маска результатов сворачивается в число.
+// Ветвлений по данным нет, поэтому цена не зависит от позиции ключа в блоке.
+// Блок должен быть выровнен на 64 байта, хвост дополнен значением не меньше любого ключа
+namespace simd_search {
+
+// Используемый набор инструкций (для вывода в бенчмарках)
+#if defined(__AVX2__)
+constexpr const char* BACKEND = "AVX2";
+#elif defined(BINARY_TREE_HAS_SSE2)
+constexpr const char* BACKEND = "SSE2";
+#else
+constexpr const char* BACKEND = "scalar";
+#endif
+
+inline size_t PopCount(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcount(mask));
+#else
+    return std::bitset<32>(mask).count();
+#endif
+}
+
+// Скалярный вариант: тоже без ветвлений (сумма результатов сравнений)
+template <typename T, size_t N>
+size_t CountLessScalar(const T* keys, const T& x) {
+    size_t count = 0;
+    for (size_t i = 0; i < N; ++i) {
+        count += static_cast<size_t>(keys[i] < x);
+    }
+    return count;
+}
+
+// Общий случай - скалярный
+template <typename T, size_t N>
+struct CountLessImpl {
+    static size_t Run(const T* keys, const T& x) {
+        return CountLessScalar<T, N>(keys, x);
+    }
+};
+
+#if defined(BINARY_TREE_HAS_SSE2)
+
+template <>
+struct CountLessImpl<int, 16> {
+    static size_t Run(const int* keys, const int& x) {
+#if defined(__AVX2__)
+        const __m256i value = _mm256_set1_epi32(x);
+        __m256i low = _mm256_cmpgt_epi32(value, _mm256_load_si256(reinterpret_cast<const __m256i*>(keys)));
+        __m256i high = _mm256_cmpgt_epi32(value, _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + 8)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(low))) |
+                        (static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(high))) << 8);
+#else
+        const __m128i value = _mm_set1_epi32(x);
+        unsigned mask = 0;
+        for (int part = 0; part < 4; ++part) {
+            __m128i block = _mm_load_si128(reinterpret_cast<const __m128i*>(keys + 4 * part));
+            mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(value, block))))
+                    << (4 * part);
+        }
+#endif
+        return PopCount(mask);
+    }
+};
+
+template <>
+struct CountLessImpl<float, 16> {
+    static size_t Run(const float* keys, const float& x) {
+#if defined(__AVX__)
+        const __m256 value = _mm256_set1_ps(x);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_load_ps(keys), value, _CMP_LT_OQ))) |
+                        (static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_load_ps(keys + 8), value, _CMP_LT_OQ))) << 8);
+#else
+        const __m128 value = _mm_set1_ps(x);
+        unsigned mask = 0;
+        for (int part = 0; part < 4; ++part) {
+            mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_cmplt_ps(_mm_load_ps(keys + 4 * part), value)))
+                    << (4 * part);
+        }
+#endif
+        return PopCount(mask);
+    }
+};
+
+template <>
+struct CountLessImpl<double, 8> {
+    static size_t Run(const double* keys, const double& x) {
+#if defined(__AVX__)
+        const __m256d value = _mm256_set1_pd(x);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_load_pd(keys), value, _CMP_LT_OQ))) |
+                        (static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_load_pd(keys + 4), value, _CMP_LT_OQ))) << 4);
+#else
+        const __m128d value = _mm_set1_pd(x);
+        unsigned mask = 0;
+        for (int part = 0; part < 4; ++part) {
+            mask |= static_cast<unsigned>(_mm_movemask_pd(_mm_cmplt_pd(_mm_load_pd(keys + 2 * part), value)))
+                    << (2 * part);
+        }
+#endif
+        return PopCount(mask);
+    }
+};
+
+#endif // BINARY_TREE_HAS_SSE2
+
+// Количество ключей из keys[0..N), строго меньших x
+// UseSimd = false - всегда скалярный вариант (для сравнения в бенчмарках)
+template <bool UseSimd, typename T, size_t N>
+size_t CountLess(const T* keys, const T& x) {
+    if constexpr (UseSimd) {
+        return CountLessImpl<T, N>::Run(keys, x);
+    } else {
+        return CountLessScalar<T, N>(keys, x);
+    }
+}
+
+} // namespace simd_search
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef BINARY_TREE_TREE_COMPARE_H
+#define BINARY_TREE_TREE_COMPARE_H
+
+#include <complex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Порядок ключей деревьев (параметр шаблона Compare у BinaryTree, FrozenBinaryTree, PersistentBinaryTree,
+// MappedBinaryTree)
+// Compare - "меньше" в смысле std::less: compare(a, b) == true, если a строго раньше b.
+// Дополнительно компаратор может определить Order(a, b) -> int (<0, 0, >0): тогда спуск по дереву
+// делает одно трёхстороннее сравнение на уровень (для строк - один проход memcmp вместо двух-трёх).
+// Прозрачный компаратор (is_transparent, как std::less<>) разрешает поиск по ключам другого типа:
+// например, по std::string_view в дереве строк без создания временной строки
+
+// Порядок по умолчанию: operator< типа T (компаратор не прозрачный - ключ сначала приводится к T,
+// иначе, например, поиск 2.5 в дереве int сравнивал бы double с int).
+// Order не определён: для чисел два "меньше" подряд компилируются в одно сравнение с двумя переходами,
+// а вычисленный без переходов знак (b < a) - (a < b) на промахах поиска медленнее
+template <typename T>
+struct TreeLess {
+    bool operator()(const T& a, const T& b) const {
+        return a < b;
+    }
+};
+
+// Строки: прозрачный порядок через std::string_view - подходят std::string, std::string_view и const char*
+template <>
+struct TreeLess<std::string> {
+    using is_transparent = void;
+
+    bool operator()(std::string_view a, std::string_view b) const {
+        return a < b;
+    }
+
+    int Order(std::string_view a, std::string_view b) const {
+        int order = a.compare(b);
+        return (order > 0) - (order < 0);
+    }
+};
+
+// Комплексные числа: лексикографически - сначала вещественная часть, затем мнимая
+// (у std::complex нет operator<)
+template <>
+struct TreeLess<std::complex<double>> {
+    bool operator()(const std::complex<double>& a, const std::complex<double>& b) const {
+        return Order(a, b) < 0;
+    }
+
+    int Order(const std::complex<double>& a, const std::complex<double>& b) const {
+        if (a.real() != b.real()) {
+            return a.real() < b.real() ? -1 : 1;
+        }
+        return (b.imag() < a.imag()) - (a.imag() < b.imag());
+    }
+};
+
+namespace tree_compare_detail {
+
+template <typename Compare, typename A, typename B, typename = void>
+struct HasOrder : std::false_type {};
+
+template <typename Compare, typename A, typename B>
+struct HasOrder<Compare, A, B,
+                std::void_t<decltype(std::declval<const Compare&>().Order(std::declval<const A&>(),
+                                                                          std::declval<const B&>()))>>
+    : std::true_type {};
+
+} // namespace tree_compare_detail
+
+// Трёхстороннее сравнение: отрицательное - a раньше b, 0 - эквивалентны, положительное - a позже b
+// Без Order у компаратора - через "меньше" (два вызова только при неравенстве в пользу b)
+template <typename Compare, typename A, typename B>
+int KeyOrder(const Compare& compare, const A& a, const B& b) {
+    if constexpr (tree_compare_detail::HasOrder<Compare, A, B>::value) {
+        return compare.Order(a, b);
+    }
+    else {
+        return compare(a, b) ? -1 : (compare(b, a) ? 1 : 0);
+    }
+}
+
+// Эквивалентность по компаратору (вместо operator==)
+template <typename Compare, typename A, typename B>
+bool KeyEquivalent(const Compare& compare, const A& a, const B& b) {
+    return KeyOrder(compare, a, b) == 0;
+}
+
+#endif
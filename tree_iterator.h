@@ -0,0 +1,122 @@
+#ifndef BINARY_TREE_ITERATOR_H
+#define BINARY_TREE_ITERATOR_H
+
+#include "node.h"
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+// Двунаправленный итератор симметричного обхода (значения в отсортированном порядке)
+// Хранит путь от корня до текущего узла: ++ и -- двигаются по нему за амортизированное O(1)
+// и не требуют указателей на родителя в Node<T>. Пустой путь - позиция end().
+// Любое изменение дерева делает итераторы недействительными (повороты AVL меняют пути)
+template <typename T>
+class TreeIterator {
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    TreeIterator() : root(nullptr) {}
+
+    reference operator*() const {
+        return path.back()->data;
+    }
+
+    pointer operator->() const {
+        return &path.back()->data;
+    }
+
+    // Переход к следующему по возрастанию значению
+    TreeIterator& operator++() {
+        Node<T>* current = path.back();
+        if (current->right) {
+            // Минимум правого поддерева
+            path.push_back(current->right);
+            DescendLeft();
+            return *this;
+        }
+        // Подъём, пока поднимаемся из правого поддерева
+        Node<T>* child = current;
+        path.pop_back();
+        while (!path.empty() && path.back()->right == child) {
+            child = path.back();
+            path.pop_back();
+        }
+        return *this;
+    }
+
+    TreeIterator operator++(int) {
+        TreeIterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    // Переход к предыдущему значению (--end() - максимум дерева)
+    TreeIterator& operator--() {
+        if (path.empty()) {
+            if (root) {
+                path.push_back(root);
+                DescendRight();
+            }
+            return *this;
+        }
+        Node<T>* current = path.back();
+        if (current->left) {
+            // Максимум левого поддерева
+            path.push_back(current->left);
+            DescendRight();
+            return *this;
+        }
+        // Подъём, пока поднимаемся из левого поддерева
+        Node<T>* child = current;
+        path.pop_back();
+        while (!path.empty() && path.back()->left == child) {
+            child = path.back();
+            path.pop_back();
+        }
+        return *this;
+    }
+
+    TreeIterator operator--(int) {
+        TreeIterator previous = *this;
+        --*this;
+        return previous;
+    }
+
+    bool operator==(const TreeIterator& other) const {
+        return Current() == other.Current();
+    }
+
+    bool operator!=(const TreeIterator& other) const {
+        return !(*this == other);
+    }
+
+private:
+    template <typename, typename, typename> friend class BinaryTree;
+
+    Node<T>* root;              // Корень дерева (нужен для --end())
+    std::vector<Node<T>*> path; // Путь от корня до текущего узла
+
+    explicit TreeIterator(Node<T>* treeRoot) : root(treeRoot) {}
+
+    Node<T>* Current() const {
+        return path.empty() ? nullptr : path.back();
+    }
+
+    void DescendLeft() {
+        while (path.back()->left) {
+            path.push_back(path.back()->left);
+        }
+    }
+
+    void DescendRight() {
+        while (path.back()->right) {
+            path.push_back(path.back()->right);
+        }
+    }
+};
+
+#endif
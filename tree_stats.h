@@ -0,0 +1,411 @@
+#ifndef BINARY_TREE_TREE_STATS_H
+#define BINARY_TREE_TREE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Инструментирование BinaryTree: счётчики операций, пройденные узлы, выделения узлов и
+// гистограммы задержек. По умолчанию не компилируется (ни полей, ни инструкций в горячих путях);
+// включается макросом BINARY_TREE_STATS (опция CMake BINARY_TREE_STATS). Макрос должен быть
+// одинаковым во всех единицах трансляции: от него зависит состав полей BinaryTree.
+// BinaryTree::Stats() доступен всегда: без инструментирования снимок содержит только
+// размер, высоту и блоки пула (enabled = false). Форма дерева (TreeShape, BinaryTree::Analyze())
+// не зависит от макроса
+
+#ifdef BINARY_TREE_STATS
+#define BINARY_TREE_STATS_ONLY(...) __VA_ARGS__
+#else
+#define BINARY_TREE_STATS_ONLY(...)
+#endif
+
+// Гистограмма с логарифмически-линейными корзинами (как в HdrHistogram)
+// Значения до 2^SUB_BITS хранятся точно, дальше каждая октава [2^e, 2^(e+1)) делится на
+// 2^SUB_BITS равных корзин - относительная погрешность не больше 1/2^SUB_BITS (~3%)
+// при фиксированном размере и записи за O(1)
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr size_t SUB_COUNT = size_t(1) << SUB_BITS;
+    static constexpr size_t BUCKETS = SUB_COUNT + (64 - SUB_BITS) * SUB_COUNT;
+
+    LatencyHistogram() : buckets{}, count(0), sum(0), min(0), max(0) {}
+
+    static size_t BucketOf(uint64_t value) {
+        if (value < SUB_COUNT) {
+            return static_cast<size_t>(value);
+        }
+        unsigned exponent = 63 - static_cast<unsigned>(LeadingZeros(value));
+        size_t sub = static_cast<size_t>(value >> (exponent - SUB_BITS)) & (SUB_COUNT - 1);
+        return SUB_COUNT + (exponent - SUB_BITS) * SUB_COUNT + sub;
+    }
+
+    // Наибольшее значение, попадающее в корзину
+    static uint64_t BucketHigh(size_t bucket) {
+        if (bucket < SUB_COUNT) {
+            return bucket;
+        }
+        size_t exponent = (bucket - SUB_COUNT) / SUB_COUNT + SUB_BITS;
+        uint64_t sub = (bucket - SUB_COUNT) % SUB_COUNT;
+        uint64_t width = uint64_t(1) << (exponent - SUB_BITS);
+        return ((SUB_COUNT + sub) << (exponent - SUB_BITS)) + (width - 1);
+    }
+
+    void Record(uint64_t value) {
+        ++buckets[BucketOf(value)];
+        if (count == 0 || value < min) min = value;
+        if (value > max) max = value;
+        ++count;
+        sum += value;
+    }
+
+    // Сборка снимка: добавление count значений в корзину (без пересчёта min/max)
+    void AddBucket(size_t bucket, uint64_t bucketCount) {
+        buckets[bucket] += bucketCount;
+        count += bucketCount;
+    }
+
+    void SetTotals(uint64_t total, uint64_t minimum, uint64_t maximum) {
+        sum = total;
+        min = minimum;
+        max = maximum;
+    }
+
+    uint64_t Count() const { return count; }
+    uint64_t Min() const { return min; }
+    uint64_t Max() const { return max; }
+    double Mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+    // Значение, не меньше которого доля quantile (0..1] записей: верхняя граница корзины, но не больше Max()
+    uint64_t Percentile(double quantile) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count)));
+        if (rank == 0) {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+            seen += buckets[bucket];
+            if (seen >= rank) {
+                uint64_t high = BucketHigh(bucket);
+                return high < max ? high : max;
+            }
+        }
+        return max;
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> buckets;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+
+    static int LeadingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#else
+        int zeros = 0;
+        for (uint64_t bit = uint64_t(1) << 63; !(value & bit); bit >>= 1) {
+            ++zeros;
+        }
+        return zeros;
+#endif
+    }
+};
+
+// Снимок статистики одной операции
+struct OperationStats {
+    uint64_t calls = 0;
+    uint64_t hits = 0;             // Insert - вставлено новое значение, Contains - найдено, Remove - удалено
+    uint64_t nodesVisited = 0;     // Сумма пройденных при спуске узлов
+    uint64_t maxNodesVisited = 0;  // Самый длинный спуск
+    LatencyHistogram latencyNs;    // Задержки в наносекундах
+
+    double MeanNodesVisited() const {
+        return calls ? static_cast<double>(nodesVisited) / calls : 0.0;
+    }
+};
+
+// Снимок статистики дерева (BinaryTree::Stats())
+struct TreeStats {
+    bool enabled = false;  // Собран ли BinaryTree с BINARY_TREE_STATS
+    size_t size = 0;
+    size_t height = 0;
+    size_t poolChunks = 0; // Блоки памяти пула узлов
+    uint64_t nodesAllocated = 0;
+    uint64_t nodesFreed = 0;
+    OperationStats insert;
+    OperationStats contains; // Contains, TryContains, Find
+    OperationStats remove;   // Remove и RemoveRange (по каждому значению)
+
+    // Высота относительно минимально возможной для size узлов: 1 - идеально сбалансированное дерево,
+    // AVL - не больше ~1.44, вырождение в список - size / log2(size + 1). Удобно для оповещений
+    double Degeneracy() const {
+        if (size == 0) {
+            return 1.0;
+        }
+        double optimal = std::ceil(std::log2(static_cast<double>(size) + 1.0));
+        return static_cast<double>(height) / optimal;
+    }
+
+    std::string ToText() const {
+        std::ostringstream out;
+        out << "size " << size << ", height " << height << ", degeneracy " << Degeneracy()
+            << ", pool chunks " << poolChunks << "\n";
+        if (!enabled) {
+            out << "instrumentation disabled (build with BINARY_TREE_STATS)\n";
+            return out.str();
+        }
+        out << "nodes allocated " << nodesAllocated << ", freed " << nodesFreed << "\n";
+        const std::pair<const char*, const OperationStats*> operations[] = {
+            {"insert", &insert}, {"contains", &contains}, {"remove", &remove}};
+        for (const auto& [name, stats] : operations) {
+            const LatencyHistogram& latency = stats->latencyNs;
+            out << name << ": calls " << stats->calls << ", hits " << stats->hits
+                << ", nodes visited mean " << stats->MeanNodesVisited() << " max " << stats->maxNodesVisited
+                << ", latency ns p50 " << latency.Percentile(0.5) << " p99 " << latency.Percentile(0.99)
+                << " p99.9 " << latency.Percentile(0.999) << " max " << latency.Max() << "\n";
+        }
+        return out.str();
+    }
+
+    std::string ToJson() const {
+        std::ostringstream out;
+        out << "{\"enabled\":" << (enabled ? "true" : "false") << ",\"size\":" << size << ",\"height\":" << height
+            << ",\"degeneracy\":" << Degeneracy() << ",\"pool_chunks\":" << poolChunks;
+        if (enabled) {
+            out << ",\"nodes_allocated\":" << nodesAllocated << ",\"nodes_freed\":" << nodesFreed;
+            const std::pair<const char*, const OperationStats*> operations[] = {
+                {"insert", &insert}, {"contains", &contains}, {"remove", &remove}};
+            for (const auto& [name, stats] : operations) {
+                const LatencyHistogram& latency = stats->latencyNs;
+                out << ",\"" << name << "\":{\"calls\":" << stats->calls << ",\"hits\":" << stats->hits
+                    << ",\"nodes_visited\":" << stats->nodesVisited << ",\"max_nodes_visited\":" << stats->maxNodesVisited
+                    << ",\"latency_ns\":{\"count\":" << latency.Count() << ",\"min\":" << latency.Min()
+                    << ",\"mean\":" << latency.Mean() << ",\"p50\":" << latency.Percentile(0.5)
+                    << ",\"p90\":" << latency.Percentile(0.9) << ",\"p99\":" << latency.Percentile(0.99)
+                    << ",\"p999\":" << latency.Percentile(0.999) << ",\"max\":" << latency.Max() << "}}";
+            }
+        }
+        out << "}";
+        return out.str();
+    }
+};
+
+// Форма дерева (BinaryTree::Analyze()): всегда доступна, считается одним обходом за O(n)
+// Глубина корня = 1, то есть глубина узла - число узлов, которые проходит успешный поиск
+struct TreeShape {
+    // Показатели баланса |h(left) - h(right)| от 0 до BALANCE_LIMIT - 1 считаются точно, большие - в последней корзине
+    static constexpr size_t BALANCE_LIMIT = 8;
+
+    size_t size = 0;
+    size_t height = 0;
+    size_t optimalHeight = 0;      // ceil(log2(size + 1)) - высота идеально сбалансированного дерева
+    size_t leaves = 0;
+    size_t oneChildNodes = 0;      // Узлы с одним потомком - звенья цепочек
+    size_t twoChildNodes = 0;
+    size_t minLeafDepth = 0;
+    size_t maxLeafDepth = 0;
+    double averageLeafDepth = 0;
+    double averageHitDepth = 0;    // Средняя глубина узла: узлов на успешный поиск
+    double averageMissDepth = 0;   // Средняя глубина пустой ссылки: узлов на неуспешный поиск
+    double cacheLinesPerLookup = 0; // Оценка кэш-линий на успешный поиск (узлы разбросаны по памяти)
+    size_t avlViolations = 0;      // Узлы с |показателем баланса| > 1
+    std::vector<size_t> depthHistogram;  // depthHistogram[d] - узлов на глубине d + 1
+    std::array<size_t, 2 * BALANCE_LIMIT + 1> balanceHistogram{}; // [BALANCE_LIMIT + bf], bf = h(left) - h(right)
+
+    static size_t OptimalHeight(size_t count) {
+        size_t height = 0;
+        while (count) {
+            count >>= 1;
+            ++height;
+        }
+        return height;
+    }
+
+    // Отношение высоты к оптимальной (1 - идеально, для AVL не больше ~1.44)
+    double Degeneracy() const {
+        return optimalHeight ? static_cast<double>(height) / optimalHeight : 1.0;
+    }
+
+    std::string ToText() const {
+        std::ostringstream out;
+        out << "size " << size << ", height " << height << " (optimal " << optimalHeight << ", degeneracy "
+            << Degeneracy() << ")\n"
+            << "leaves " << leaves << ", one child " << oneChildNodes << ", two children " << twoChildNodes
+            << ", AVL violations " << avlViolations << "\n"
+            << "leaf depth min " << minLeafDepth << " avg " << averageLeafDepth << " max " << maxLeafDepth << "\n"
+            << "lookup depth hit " << averageHitDepth << " miss " << averageMissDepth
+            << ", cache lines per hit ~" << cacheLinesPerLookup << "\n"
+            << "depth histogram:";
+        for (size_t depth = 0; depth < depthHistogram.size(); ++depth) {
+            if (depthHistogram[depth]) {
+                out << " " << depth + 1 << ":" << depthHistogram[depth];
+            }
+        }
+        out << "\nbalance factors:";
+        for (size_t index = 0; index < balanceHistogram.size(); ++index) {
+            if (balanceHistogram[index]) {
+                int factor = static_cast<int>(index) - static_cast<int>(BALANCE_LIMIT);
+                out << " " << (index == 0 ? "<=" : index + 1 == balanceHistogram.size() ? ">=" : "")
+                    << factor << ":" << balanceHistogram[index];
+            }
+        }
+        out << "\n";
+        return out.str();
+    }
+
+    std::string ToJson() const {
+        std::ostringstream out;
+        out << "{\"size\":" << size << ",\"height\":" << height << ",\"optimal_height\":" << optimalHeight
+            << ",\"leaves\":" << leaves << ",\"one_child_nodes\":" << oneChildNodes
+            << ",\"two_child_nodes\":" << twoChildNodes << ",\"avl_violations\":" << avlViolations
+            << ",\"min_leaf_depth\":" << minLeafDepth << ",\"max_leaf_depth\":" << maxLeafDepth
+            << ",\"average_leaf_depth\":" << averageLeafDepth << ",\"average_hit_depth\":" << averageHitDepth
+            << ",\"average_miss_depth\":" << averageMissDepth
+            << ",\"cache_lines_per_lookup\":" << cacheLinesPerLookup << ",\"depth_histogram\":[";
+        for (size_t depth = 0; depth < depthHistogram.size(); ++depth) {
+            out << (depth ? "," : "") << depthHistogram[depth];
+        }
+        out << "],\"balance_histogram\":{";
+        for (size_t index = 0; index < balanceHistogram.size(); ++index) {
+            out << (index ? "," : "") << "\"" << static_cast<int>(index) - static_cast<int>(BALANCE_LIMIT)
+                << "\":" << balanceHistogram[index];
+        }
+        out << "}}";
+        return out.str();
+    }
+};
+
+#ifdef BINARY_TREE_STATS
+
+// Живые счётчики одной операции
+// Атомарные (relaxed): константные операции поиска можно вызывать из нескольких потоков
+class OperationRecorder {
+public:
+    OperationRecorder() { Reset(); }
+
+    void Record(uint64_t visited, bool hit, uint64_t latency) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        if (hit) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        nodesVisited.fetch_add(visited, std::memory_order_relaxed);
+        UpdateMax(maxNodesVisited, visited);
+        buckets[LatencyHistogram::BucketOf(latency)].fetch_add(1, std::memory_order_relaxed);
+        latencySum.fetch_add(latency, std::memory_order_relaxed);
+        UpdateMax(latencyMax, latency);
+        uint64_t currentMin = latencyMin.load(std::memory_order_relaxed);
+        while (latency < currentMin &&
+               !latencyMin.compare_exchange_weak(currentMin, latency, std::memory_order_relaxed)) {
+        }
+    }
+
+    OperationStats Snapshot() const {
+        OperationStats result;
+        result.calls = calls.load(std::memory_order_relaxed);
+        result.hits = hits.load(std::memory_order_relaxed);
+        result.nodesVisited = nodesVisited.load(std::memory_order_relaxed);
+        result.maxNodesVisited = maxNodesVisited.load(std::memory_order_relaxed);
+        for (size_t bucket = 0; bucket < LatencyHistogram::BUCKETS; ++bucket) {
+            uint64_t bucketCount = buckets[bucket].load(std::memory_order_relaxed);
+            if (bucketCount) {
+                result.latencyNs.AddBucket(bucket, bucketCount);
+            }
+        }
+        uint64_t minimum = latencyMin.load(std::memory_order_relaxed);
+        result.latencyNs.SetTotals(latencySum.load(std::memory_order_relaxed),
+                                   result.latencyNs.Count() ? minimum : 0,
+                                   latencyMax.load(std::memory_order_relaxed));
+        return result;
+    }
+
+    void Reset() {
+        calls = 0;
+        hits = 0;
+        nodesVisited = 0;
+        maxNodesVisited = 0;
+        for (std::atomic<uint64_t>& bucket : buckets) {
+            bucket = 0;
+        }
+        latencySum = 0;
+        latencyMin = UINT64_MAX;
+        latencyMax = 0;
+    }
+
+private:
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> nodesVisited;
+    std::atomic<uint64_t> maxNodesVisited;
+    std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS> buckets;
+    std::atomic<uint64_t> latencySum;
+    std::atomic<uint64_t> latencyMin;
+    std::atomic<uint64_t> latencyMax;
+
+    static void UpdateMax(std::atomic<uint64_t>& target, uint64_t value) {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+// Счётчики дерева. Копия дерева начинает с нулевой статистики
+class TreeStatsRecorder {
+public:
+    OperationRecorder insert;
+    OperationRecorder contains;
+    OperationRecorder remove;
+    std::atomic<uint64_t> nodesAllocated{0};
+    std::atomic<uint64_t> nodesFreed{0};
+
+    TreeStatsRecorder() = default;
+    TreeStatsRecorder(const TreeStatsRecorder&) {}
+    TreeStatsRecorder& operator=(const TreeStatsRecorder&) { return *this; }
+
+    void Reset() {
+        insert.Reset();
+        contains.Reset();
+        remove.Reset();
+        nodesAllocated = 0;
+        nodesFreed = 0;
+    }
+};
+
+// Замер одной операции: время от создания до уничтожения (в том числе при исключении),
+// пройденные узлы - Visit(), успех - Hit()
+class OperationScope {
+public:
+    explicit OperationScope(OperationRecorder& target)
+        : recorder(target), visited(0), hit(false), start(std::chrono::steady_clock::now()) {}
+
+    OperationScope(const OperationScope&) = delete;
+    OperationScope& operator=(const OperationScope&) = delete;
+
+    ~OperationScope() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        recorder.Record(visited, hit, static_cast<uint64_t>(elapsed.count()));
+    }
+
+    void Visit() { ++visited; }
+    void Hit() { hit = true; }
+
+private:
+    OperationRecorder& recorder;
+    uint64_t visited;
+    bool hit;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // BINARY_TREE_STATS
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef BINARY_TREE_STREAM_H
+#define BINARY_TREE_STREAM_H
+
+#include <cerrno>
+#include <cstddef>
+#include <ios>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <unistd.h> // read, write, lseek
+
+// Потоковый ввод-вывод для сериализации: все буферы здесь фиксированного размера,
+// поэтому запись и чтение дерева не требуют держать в памяти весь текст целиком
+
+// Размер буфера по умолчанию
+constexpr size_t STREAM_BUFFER_SIZE = 1 << 16;
+
+// Буфер потока поверх файлового дескриптора (POSIX read/write)
+// Дескриптор не закрывается - им владеет вызывающий код.
+// Работает в одном направлении: std::ios_base::in - чтение, std::ios_base::out - запись.
+// Чтение идёт порциями с упреждением: при разрушении непрочитанный остаток буфера возвращается
+// в дескриптор сдвигом позиции назад. Для каналов и сокетов сдвиг невозможен - прочитанные
+// наперёд байты теряются
+class FdStreamBuf : public std::streambuf {
+public:
+    FdStreamBuf(int descriptor, std::ios_base::openmode mode, size_t bufferSize = STREAM_BUFFER_SIZE)
+        : fd(descriptor), buffer(bufferSize) {
+        if (mode & std::ios_base::out) {
+            setp(buffer.data(), buffer.data() + buffer.size());
+        } else {
+            setg(buffer.data(), buffer.data(), buffer.data());
+        }
+    }
+
+    FdStreamBuf(const FdStreamBuf&) = delete;
+    FdStreamBuf& operator=(const FdStreamBuf&) = delete;
+
+    ~FdStreamBuf() override {
+        sync();
+        if (eback() && gptr() < egptr()) {
+            // Ошибка (ESPIPE для несмещаемых дескрипторов) не исправима - игнорируем
+            ::lseek(fd, -static_cast<off_t>(egptr() - gptr()), SEEK_CUR);
+        }
+    }
+
+protected:
+    // Буфер записи заполнен - сбрасываем его в дескриптор
+    int_type overflow(int_type ch) override {
+        if (!pbase() || !FlushBuffer()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override {
+        return (!pbase() || FlushBuffer()) ? 0 : -1;
+    }
+
+    // Буфер чтения исчерпан - читаем следующую порцию
+    int_type underflow() override {
+        if (!eback()) {
+            return traits_type::eof();
+        }
+        ssize_t count;
+        do {
+            count = ::read(fd, buffer.data(), buffer.size());
+        } while (count < 0 && errno == EINTR);
+        if (count <= 0) {
+            return traits_type::eof();
+        }
+        setg(buffer.data(), buffer.data(), buffer.data() + count);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    int fd;
+    std::vector<char> buffer;
+
+    bool FlushBuffer() {
+        const char* data = pbase();
+        while (data < pptr()) {
+            ssize_t written = ::write(fd, data, static_cast<size_t>(pptr() - data));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+        }
+        setp(buffer.data(), buffer.data() + buffer.size());
+        return true;
+    }
+};
+
+// Буфер потока только для чтения поверх готового блока памяти (без копирования)
+class MemoryStreamBuf : public std::streambuf {
+public:
+    MemoryStreamBuf(const char* data, size_t size) {
+        char* begin = const_cast<char*>(data); // Буфер только читается
+        setg(begin, begin, begin + size);
+    }
+};
+
+// Приёмник токенов текстового формата
+// Без потока - просто дописывает в строку (serialize() в строку).
+// С потоком - копит не больше STREAM_BUFFER_SIZE байт и сбрасывает их в поток
+class TokenWriter {
+public:
+    explicit TokenWriter(std::string& output, std::ostream* stream = nullptr) : text(output), out(stream) {
+        if (out) {
+            text.reserve(STREAM_BUFFER_SIZE + 256);
+        }
+    }
+
+    TokenWriter& operator+=(const std::string& token) {
+        text += token;
+        Check();
+        return *this;
+    }
+
+    TokenWriter& operator+=(const char* token) {
+        text += token;
+        Check();
+        return *this;
+    }
+
+    TokenWriter& operator+=(char symbol) {
+        text += symbol;
+        Check();
+        return *this;
+    }
+
+    // Сброс накопленного текста в поток
+    void Flush() {
+        if (out && !text.empty()) {
+            out->write(text.data(), static_cast<std::streamsize>(text.size()));
+            text.clear();
+        }
+    }
+
+private:
+    std::string& text;
+    std::ostream* out;
+
+    void Check() {
+        if (out && text.size() >= STREAM_BUFFER_SIZE) {
+            Flush();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef BINARY_TREE_WORK_STEALING_POOL_H
+#define BINARY_TREE_WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing)
+// У каждого участника своя очередь: свои задачи берутся с конца (LIFO - горячие данные в кэше),
+// чужие - с начала (FIFO - самые крупные, ещё не разделённые задачи). Задача, запущенная
+// из задачи, попадает в очередь текущего потока, так что рекурсивное деление работы
+// (например, по поддеревьям) само распределяется между простаивающими потоками.
+// Участник 0 - поток, вызвавший Wait(): он выполняет задачи наравне с рабочими
+class WorkStealingPool {
+public:
+    // threads - общее число участников, включая вызывающий поток (0 - по числу ядер)
+    explicit WorkStealingPool(unsigned threads = 0) : pending(0), queued(0), stop(false) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back([this, i]() { WorkerLoop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    unsigned ThreadCount() const {
+        return static_cast<unsigned>(queues.size());
+    }
+
+    // Постановка задачи: из потока пула - в его очередь, из внешнего потока - в очередь 0
+    void Submit(std::function<void()> task) {
+        size_t index = currentPool == this ? currentIndex : 0;
+        pending.fetch_add(1, std::memory_order_relaxed);
+        queued.fetch_add(1, std::memory_order_release); // До вставки: счётчик не уходит ниже нуля
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex); // Чтобы не потерять пробуждение
+        }
+        wake.notify_one();
+    }
+
+    // Ожидание завершения всех задач (вызывающий поток помогает их выполнять)
+    // Первое исключение из задач пробрасывается отсюда
+    void Wait() {
+        const WorkStealingPool* previousPool = currentPool;
+        size_t previousIndex = currentIndex;
+        currentPool = this;
+        currentIndex = 0;
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (!TryRun(0)) {
+                std::this_thread::yield();
+            }
+        }
+        currentPool = previousPool;
+        currentIndex = previousIndex;
+
+        std::exception_ptr failure;
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            std::swap(failure, error);
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pending; // Поставлены, но не завершены
+    std::atomic<size_t> queued;  // Лежат в очередях
+    bool stop;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    // Пул и номер очереди текущего потока
+    inline static thread_local const WorkStealingPool* currentPool = nullptr;
+    inline static thread_local size_t currentIndex = 0;
+
+    // Взятие задачи: своя очередь с конца, иначе перехват из чужих с начала
+    bool TryRun(size_t self) {
+        std::function<void()> task;
+        if (!Pop(self, task)) {
+            for (size_t step = 1; step < queues.size() && !task; ++step) {
+                Steal((self + step) % queues.size(), task);
+            }
+            if (!task) {
+                return false;
+            }
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        try {
+            task();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool Pop(size_t index, std::function<void()>& task) {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        if (queues[index]->tasks.empty()) {
+            return false;
+        }
+        task = std::move(queues[index]->tasks.back());
+        queues[index]->tasks.pop_back();
+        return true;
+    }
+
+    bool Steal(size_t index, std::function<void()>& task) {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        if (queues[index]->tasks.empty()) {
+            return false;
+        }
+        task = std::move(queues[index]->tasks.front());
+        queues[index]->tasks.pop_front();
+        return true;
+    }
+
+    void WorkerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+        while (true) {
+            if (TryRun(index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]() { return stop || queued.load(std::memory_order_acquire) > 0; });
+            if (stop) {
+                return;
+            }
+        }
+    }
+};
+
+#endif